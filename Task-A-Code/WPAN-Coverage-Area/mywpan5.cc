@@ -10,6 +10,8 @@
 #include "ns3/applications-module.h"
 #include "ns3/ipv6-flow-classifier.h"
 #include "ns3/flow-monitor-helper.h"
+#include "ns3/flow-stats-file.h"
+#include "ns3/range-spectrum-channel.h"
 #include <ns3/lr-wpan-error-model.h>
 #include <string>
 #include <cmath>
@@ -18,8 +20,8 @@ using namespace ns3;
 
 uint n_flows=3, n_nodes=3, sinkPort=9, maxRange=10, gap=1;
 uint start_time=0, stop_time, duration=100, pkts_ps=100, pkt_sz=100;
-bool verbose = false;
-string filePrefix, congestionAlgo = "TcpNewReno", recoveryAlgo="ns3::TcpClassicRecovery";
+bool verbose = false, spatialIndex = false;
+string filePrefix, flowFormat = "bin", congestionAlgo = "TcpNewReno", recoveryAlgo="ns3::TcpClassicRecovery";
 
 void processArguments(int argc, char** argv) {
     CommandLine cmd (__FILE__);
@@ -30,8 +32,10 @@ void processArguments(int argc, char** argv) {
     cmd.AddValue ("n_nodes", "Number of Nodes", n_nodes);
     cmd.AddValue ("verbose", "Print In Console", verbose);
     cmd.AddValue ("duration", "Duration", duration);
+    cmd.AddValue ("flowFormat", "FlowMonitor Output (bin or xml)", flowFormat);
     cmd.AddValue ("maxRange", "Max Range", maxRange);
     cmd.AddValue ("gap", "Gap", gap);
+    cmd.AddValue ("spatialIndex", "Only Deliver Transmissions Within maxRange", spatialIndex);
     cmd.Parse (argc, argv);
 
     if( n_nodes<1 ) {
@@ -97,7 +101,12 @@ int main (int argc, char** argv) {
 
     LrWpanHelper lrWpanHelper;
     Config::SetDefault ("ns3::RangePropagationLossModel::MaxRange", DoubleValue (maxRange));
-    Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+    Ptr<SpectrumChannel> channel;
+    if( spatialIndex ) {
+        channel = CreateObject<RangeSpectrumChannel> ();
+        channel->SetAttribute ("MaxRange", DoubleValue (maxRange));
+    }
+    else channel = CreateObject<SingleModelSpectrumChannel> ();
     Ptr<RangePropagationLossModel> propModel = CreateObject<RangePropagationLossModel> ();
     Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel> ();
     channel->AddPropagationLossModel (propModel);
@@ -168,7 +177,8 @@ int main (int argc, char** argv) {
     Simulator::Stop (Seconds (stop_time));
     Simulator::Run ();
 
-    flowHelper.SerializeToXmlFile (filePrefix + ".flowmonitor", true, true);
+    if( flowFormat=="xml" ) flowHelper.SerializeToXmlFile (filePrefix + ".flowmonitor", true, true);
+    else FlowStatsFile::Serialize (flowHelper.GetMonitor (), filePrefix + ".flowstats");
 
     Simulator::Destroy ();
 
@@ -1,13 +1,13 @@
 #!/bin/bash
 
-rm *.flowmonitor
+rm *.flowmonitor *.flowstats
 
 declare -a maxRange=(1, 2, 3, 4, 5)
 
 for r in ${maxRange[@]}; do
-    ./waf --run "scratch/mywpan5  --maxRange=$r --duration=100"
+    ./waf --run "scratch/mywpan5  --maxRange=$r --duration=100 --spatialIndex=1"
 done
 
-python3 processFlowA_wpan2.py
+if [ -x ./processFlows ]; then ./processFlows --layout=coverage; else python3 processFlowA_wpan2.py; fi
 
 libreoffice --headless --convert-to xlsx:"Calc MS Excel 2007 XML" results.csv
\ No newline at end of file
@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# Runs/minute of the small Task A WPAN grid: one ./waf --run per point,
+# a --sweep forking one worker per point, and --batch running all the
+# points of a worker in one process. Run from the ns-3 directory after
+# ./waf build.
+
+nodes="2 3 4 5 6 7 8 9 10"
+args="--n_flows=4 --pkts_ps=200 --duration=20"
+n=$(echo $nodes | wc -w)
+
+start=$(date +%s.%N)
+for node in $nodes; do
+    ./waf --run "scratch/mywpan4 --n_nodes=$node $args" > /dev/null
+done
+end=$(date +%s.%N)
+echo "separate runs: $(echo "$n*60/($end-$start)" | bc -l | xargs printf "%.1f") runs/min"
+
+for batch in 1 $n; do
+    ./waf --run "scratch/mywpan4 --sweep=n_nodes=${nodes// /,} $args --jobs=1 --batch=$batch" | grep "runs/min" |
+        sed "s/^/--batch=$batch: /"
+done
+
+rm -f *.flowstats
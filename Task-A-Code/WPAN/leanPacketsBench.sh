@@ -0,0 +1,14 @@
+#!/bin/bash
+
+# Wall time and peak RSS of large mesh-under WPAN runs with and without
+# --leanPackets. Run from the ns-3 directory after ./waf build.
+
+for nodes in 20 40 80; do
+    for lean in 0 1; do
+        /usr/bin/time -f "n_nodes=$nodes leanPackets=$lean: %e s, %M KB peak RSS" \
+            ./waf --run "scratch/mywpan4 --n_nodes=$nodes --n_flows=$nodes --pkts_ps=100 --duration=60 --leanPackets=$lean" |
+            grep "Lean Packets"
+    done
+done
+
+rm -f *.flowstats
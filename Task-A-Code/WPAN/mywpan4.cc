@@ -10,16 +10,23 @@
 #include "ns3/applications-module.h"
 #include "ns3/ipv6-flow-classifier.h"
 #include "ns3/flow-monitor-helper.h"
+#include "ns3/sweep-runner.h"
+#include "ns3/flow-stats-file.h"
+#include "ns3/flow-metrics-aggregator.h"
+#include "ns3/lean-packets-helper.h"
 #include <ns3/lr-wpan-error-model.h>
 #include <string>
+#include <algorithm>
 #include <cmath>
+#include <chrono>
+#include <sys/resource.h>
 using namespace std;
 using namespace ns3;
 
-uint n_flows=3, n_nodes=5, sinkPort=9;
+uint n_flows=3, n_nodes=5, sinkPort=9, gateways=1;
 uint start_time=0, stop_time, duration=100, pkts_ps=20, pkt_sz=100;
-bool verbose = false;
-string filePrefix, congestionAlgo = "TcpNewReno", recoveryAlgo="ns3::TcpClassicRecovery";
+bool verbose = false, benchmarkScheduler = false, leanPackets = false;
+string filePrefix, flowFormat = "bin", gatewayAssign = "nearest", scheduler = "Map", congestionAlgo = "TcpNewReno", recoveryAlgo="ns3::TcpClassicRecovery";
 
 void processArguments(int argc, char** argv) {
     CommandLine cmd (__FILE__);
@@ -30,8 +37,21 @@ void processArguments(int argc, char** argv) {
     cmd.AddValue ("n_nodes", "Number of Nodes", n_nodes);
     cmd.AddValue ("verbose", "Print In Console", verbose);
     cmd.AddValue ("duration", "Duration", duration);
+    cmd.AddValue ("flowFormat", "FlowMonitor Output (bin or xml)", flowFormat);
+    cmd.AddValue ("scheduler", "Event Scheduler (Map, Heap, List, Calendar, Ladder)", scheduler);
+    cmd.AddValue ("benchmarkScheduler", "Print Events/s And Peak Memory Of The Run", benchmarkScheduler);
+    cmd.AddValue ("leanPackets", "Strip Tags FlowMonitor Doesn't Need At Each Hop", leanPackets);
+    cmd.AddValue ("gateways", "Number of Border Routers, Each With Its Own Uplink And Sink", gateways);
+    cmd.AddValue ("gatewayAssign", "Gateway Of Each Flow (nearest or hash)", gatewayAssign);
     cmd.Parse (argc, argv);
 
+    TypeId schedulerType;
+    if( !TypeId::LookupByNameFailSafe ("ns3::"+scheduler+"Scheduler", &schedulerType) ) {
+        std::cout << "Unknown Scheduler " << scheduler << "\n";
+        exit(0);
+    }
+    GlobalValue::Bind ("SchedulerType", TypeIdValue (schedulerType));
+
     if( n_nodes<1 ) {
         std::cout << "Minimum 1 Node Required\n";
         exit(0);
@@ -44,9 +64,22 @@ void processArguments(int argc, char** argv) {
         std::cout << "Minimum 10s Duration Required\n";
         exit(0);
     }
+    else if( gateways<1 ) {
+        std::cout << "Minimum 1 Gateway Required\n";
+        exit(0);
+    }
+    else if( gateways>n_nodes ) {
+        std::cout << "At Most " << n_nodes << " Gateways For " << n_nodes << " Nodes\n";
+        exit(0);
+    }
+    else if( gatewayAssign!="nearest" && gatewayAssign!="hash" ) {
+        std::cout << "Unknown Gateway Assignment " << gatewayAssign << "\n";
+        exit(0);
+    }
 
     std::cout << "\n--------------------------------------------------------------------------\n";
     std::cout << "Nodes: " << n_nodes << ", Flows: " << n_flows << ", Packets PPS: " << pkts_ps;
+    if( gateways>1 ) std::cout << ", Gateways: " << gateways << " (" << gatewayAssign << ")";
     std::cout << "\n--------------------------------------------------------------------------\n";
 
     if(verbose) LogComponentEnable("PacketSink", LOG_LEVEL_INFO);
@@ -54,9 +87,9 @@ void processArguments(int argc, char** argv) {
     stop_time = start_time + duration + 2;
 
     filePrefix = "wpan-"+to_string(n_nodes)+"-"+to_string(n_flows)+"-"+to_string(pkts_ps); 
+    if( gateways>1 ) filePrefix += "-gw"+to_string(gateways);
 
-    congestionAlgo = "ns3::" + congestionAlgo;
-    Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue (congestionAlgo));
+    Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue ("ns3::" + congestionAlgo));
     Config::SetDefault ("ns3::TcpL4Protocol::RecoveryType", StringValue (recoveryAlgo));  
     Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (1 << 22));
     Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (1 << 22));
@@ -66,17 +99,54 @@ void processArguments(int argc, char** argv) {
     Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (pkt_sz));
 }
 
-int main (int argc, char** argv) {
-    processArguments(argc, argv);
+// events/s and peak memory of the run, for schedulerBench.sh
+void printSchedulerStats(chrono::steady_clock::time_point runStart) {
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - runStart;
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << "Scheduler: " << scheduler << ", Events: " << Simulator::GetEventCount ()
+              << ", Run: " << elapsed.count() << " s, Events/s: " << Simulator::GetEventCount ()/elapsed.count()
+              << ", Max RSS: " << usage.ru_maxrss/1024 << " MB\n";
+}
+
+// placeGateways, assignGateway and the gateway routes in runSimulation are the same
+// in mywpanB.cc; change both together
+// border routers spread evenly along the line, a single one stays at the center
+vector<uint> placeGateways(uint centerNode) {
+    vector<uint> gatewayNodes;
+    if( gateways==1 ) gatewayNodes.push_back(centerNode);
+    else for( uint g=0; g<gateways; g++ ) gatewayNodes.push_back(((2*g+1)*(n_nodes+1))/(2*gateways));
+    return gatewayNodes;
+}
+
+// the uplink a flow leaves through: the border router closest to its
+// source, or a hash of the flow, which also spreads one node's flows
+uint assignGateway(NodeContainer& wirelessNodes, vector<uint>& gatewayNodes, uint sourceNode, uint flow) {
+    if( gatewayAssign=="hash" ) return ((sourceNode*31+flow)*2654435761u >> 16) % gatewayNodes.size();
+
+    Ptr<MobilityModel> source = wirelessNodes.Get (sourceNode)->GetObject<MobilityModel> ();
+    uint nearest = 0;
+    double nearestDistance = source->GetDistanceFrom (wirelessNodes.Get (gatewayNodes[0])->GetObject<MobilityModel> ());
+    for( uint g=1; g<gatewayNodes.size(); g++ ) {
+        double distance = source->GetDistanceFrom (wirelessNodes.Get (gatewayNodes[g])->GetObject<MobilityModel> ());
+        if( distance<nearestDistance ) {
+            nearest = g;
+            nearestDistance = distance;
+        }
+    }
+    return nearest;
+}
 
+void runSimulation() {
     NodeContainer wirelessNodes;
     wirelessNodes.Create (n_nodes+1);
 
     uint centerNode = n_nodes/2;
+    vector<uint> gatewayNodes = placeGateways(centerNode);
 
+    // one wired sink behind each border router
     NodeContainer wiredNodes;
-    wiredNodes.Create (1);
-    wiredNodes.Add (wirelessNodes.Get (centerNode));
+    wiredNodes.Create (gateways);
 
     InternetStackHelper internetv6;
     internetv6.InstallAll();
@@ -105,26 +175,44 @@ int main (int argc, char** argv) {
     NetDeviceContainer lrwpanNetDevices = lrWpanHelper.Install (wirelessNodes);
     lrWpanHelper.AssociateToPan (lrwpanNetDevices, 0);
 
+    LeanPacketsHelper leanPacketsHelper;
+    if( leanPackets ) leanPacketsHelper.Install (lrwpanNetDevices);
+
     SixLowPanHelper sixLowPanHelper;
     NetDeviceContainer sixLowPanNetDevices = sixLowPanHelper.Install (lrwpanNetDevices);
 
     PointToPointHelper p2pHelper;
     p2pHelper.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
     p2pHelper.SetChannelAttribute ("Delay", StringValue ("0.01ms"));
-    NetDeviceContainer p2pDevices = p2pHelper.Install (wiredNodes);
 
     Ipv6AddressHelper ipv6;
     ipv6.SetBase (Ipv6Address ("2001:cafe::"), Ipv6Prefix (64));
-    Ipv6InterfaceContainer wiredDeviceInterfaces;
-    wiredDeviceInterfaces = ipv6.Assign (p2pDevices);
-    wiredDeviceInterfaces.SetForwarding (1, true);
-    wiredDeviceInterfaces.SetDefaultRouteInAllNodes (1);
+    vector<Ipv6InterfaceContainer> wiredDeviceInterfaces;
+    for( uint g=0; g<gateways; g++ ) {
+        NetDeviceContainer p2pDevices = p2pHelper.Install (wiredNodes.Get (g), wirelessNodes.Get (gatewayNodes[g]));
+        if( g>0 ) ipv6.NewNetwork();
+        wiredDeviceInterfaces.push_back (ipv6.Assign (p2pDevices));
+        wiredDeviceInterfaces[g].SetForwarding (1, true);
+        wiredDeviceInterfaces[g].SetDefaultRouteInAllNodes (1);
+    }
 
     ipv6.NewNetwork();
     Ipv6InterfaceContainer wsnDeviceInterfaces;
     wsnDeviceInterfaces = ipv6.Assign (sixLowPanNetDevices);
-    wsnDeviceInterfaces.SetForwarding (centerNode, true);
-    wsnDeviceInterfaces.SetDefaultRouteInAllNodes (centerNode);
+    for( uint g=0; g<gateways; g++ ) wsnDeviceInterfaces.SetForwarding (gatewayNodes[g], true);
+    wsnDeviceInterfaces.SetDefaultRouteInAllNodes (gatewayNodes[0]);
+
+    // the other uplinks' networks are routed through their own border router
+    Ipv6StaticRoutingHelper routingHelper;
+    for( uint g=1; g<gateways; g++ ) {
+        Ipv6Address uplinkNetwork = wiredDeviceInterfaces[g].GetAddress (0, 1).CombinePrefix (Ipv6Prefix (64));
+        for( uint n=0; n<=n_nodes; n++ ) {
+            if( n==gatewayNodes[g] ) continue;
+            Ptr<Ipv6StaticRouting> routing = routingHelper.GetStaticRouting (wirelessNodes.Get (n)->GetObject<Ipv6> ());
+            routing->AddNetworkRouteTo (uplinkNetwork, Ipv6Prefix (64), wsnDeviceInterfaces.GetLinkLocalAddress (gatewayNodes[g]),
+                                        wsnDeviceInterfaces.GetInterfaceIndex (n));
+        }
+    }
 
     for (uint32_t i = 0; i < sixLowPanNetDevices.GetN (); i++) {
         Ptr<NetDevice> dev = sixLowPanNetDevices.Get (i);
@@ -135,7 +223,7 @@ int main (int argc, char** argv) {
     PacketSinkHelper sinkApp ("ns3::TcpSocketFactory",
     Inet6SocketAddress (Ipv6Address::GetAny (), sinkPort));
     sinkApp.SetAttribute ("Protocol", TypeIdValue (TcpSocketFactory::GetTypeId ()));
-    ApplicationContainer sinkApps = sinkApp.Install (wiredNodes.Get(0));
+    ApplicationContainer sinkApps = sinkApp.Install (wiredNodes);
     sinkApps.Start (Seconds (start_time+5));
     sinkApps.Stop (Seconds (stop_time-5));
 
@@ -148,9 +236,17 @@ int main (int argc, char** argv) {
       if( i>0 ) i--;
       if( j<n_nodes ) j++;
     }
+    // the center node sends as well once it's no border router
+    if( gateways>1 ) {
+        sources.insert(sources.begin(), centerNode);
+        for( uint g : gatewayNodes ) sources.erase(remove(sources.begin(), sources.end(), g), sources.end());
+    }
+    vector<uint> gatewayFlows (gateways, 0);
     for( uint i=1, sourceNode=0; i<=n_flows; ) {
+        uint gateway = assignGateway(wirelessNodes, gatewayNodes, sources[sourceNode], i);
+        gatewayFlows[gateway]++;
         OnOffHelper sourceApp ("ns3::TcpSocketFactory",
-                                    Inet6SocketAddress (wiredDeviceInterfaces.GetAddress (0, 1), 
+                                    Inet6SocketAddress (wiredDeviceInterfaces[gateway].GetAddress (0, 1), 
                                     sinkPort));
         sourceApp.SetAttribute ("PacketSize", UintegerValue (pkt_sz));
         sourceApp.SetAttribute ("MaxBytes", UintegerValue (0));
@@ -163,16 +259,56 @@ int main (int argc, char** argv) {
         if( sourceNode==sources.size()-1 ) sourceNode=0;
         else sourceNode++;
     }
+    if( gateways>1 ) {
+        std::cout << "Flows Per Gateway:";
+        for( uint g=0; g<gateways; g++ ) std::cout << " " << gatewayFlows[g] << "@" << gatewayNodes[g];
+        std::cout << "\n";
+    }
 
     FlowMonitorHelper flowHelper;
+    // one histogram bin each, FlowMonitor's counters are all the run needs
+    if( leanPackets ) {
+        flowHelper.SetMonitorAttribute ("DelayBinWidth", DoubleValue (stop_time));
+        flowHelper.SetMonitorAttribute ("JitterBinWidth", DoubleValue (stop_time));
+        flowHelper.SetMonitorAttribute ("PacketSizeBinWidth", DoubleValue (65536));
+        flowHelper.SetMonitorAttribute ("FlowInterruptionsBinWidth", DoubleValue (stop_time));
+    }
     flowHelper.InstallAll ();
 
     Simulator::Stop (Seconds (stop_time));
+    chrono::steady_clock::time_point runStart = chrono::steady_clock::now();
     Simulator::Run ();
 
-    flowHelper.SerializeToXmlFile (filePrefix + ".flowmonitor", true, true);
+    if( benchmarkScheduler ) printSchedulerStats(runStart);
+    if( leanPackets ) std::cout << "Lean Packets: " << leanPacketsHelper.GetStrippedTags () << " Tags Stripped\n";
+    if( SweepRunner::IsReplicating () ) {
+        FlowMetrics metrics = FlowMetricsAggregator (flowHelper.GetMonitor ()).Summarize ();
+        SweepRunner::Report ({{"Throughput", metrics.throughput}, {"Delay", metrics.delay}});
+    }
+
+    if( flowFormat=="xml" ) flowHelper.SerializeToXmlFile (filePrefix + ".flowmonitor", true, true);
+    else FlowStatsFile::Serialize (flowHelper.GetMonitor (), filePrefix + ".flowstats");
 
     Simulator::Destroy ();
+}
+
+// --batch runs points back to back in one process: what SweepRunner
+// doesn't reset, and the arguments don't set again, starts over here
+void resetScenario() {
+    Ipv6AddressGenerator::Reset ();
+}
+
+void runPoint(int argc, char** argv) {
+    resetScenario();
+    processArguments(argc, argv);
+    runSimulation();
+}
+
+int main (int argc, char** argv) {
+    SweepRunner sweep;
+    if( sweep.Parse(argc, argv) ) return sweep.Run(MakeCallback(&runPoint));
+
+    runPoint(argc, argv);
 
     return 0;
 }
@@ -1,8 +1,9 @@
 import xml.etree.ElementTree as ET
 import os
 import pandas as pd
+import numpy as np
 
-df = pd.DataFrame(columns=['Nodes', 'Flows', 'Packets Per Second', 'Throughput', 
+df = pd.DataFrame(columns=['Nodes', 'Flows', 'Packets Per Second', 'Gateways', 'Throughput', 
                            'End to End Delay', 'Delivery Ratio', 'Drop Ratio'])
 
 def process(path):
@@ -33,20 +34,55 @@ def process(path):
 
     return totalThroughPut, e2eDelay, deliveryRatio, dropRatio
 
+# column order of the .flowstats files written by FlowStatsFile::Serialize
+FLOWSTATS_COLUMNS = ['flowId', 'timeFirstTxPacket', 'timeFirstRxPacket', 'timeLastTxPacket',
+                     'timeLastRxPacket', 'delaySum', 'jitterSum', 'lastDelay', 'txBytes',
+                     'rxBytes', 'txPackets', 'rxPackets', 'lostPackets', 'timesForwarded']
+
+def load_flowstats(path):
+    magic = np.fromfile(path, dtype='S8', count=1)[0]
+    if magic != b'NS3FLOWS':
+        raise ValueError(path + " is not a .flowstats file")
+    version, n_columns = np.fromfile(path, dtype='<u4', count=2, offset=8)
+    n_flows = int(np.fromfile(path, dtype='<u8', count=1, offset=16)[0])
+    columns = np.memmap(path, dtype='<i8', mode='r', offset=32, shape=(n_columns, n_flows))
+    return dict(zip(FLOWSTATS_COLUMNS, columns))
+
+def process_flowstats(path):
+    flows = load_flowstats(path)
+    half = (len(flows['flowId'])+1)//2
+    flows = {k: v[:half] for k, v in flows.items()}
+
+    totalPacketsSent = int(np.sum(flows['txPackets']))
+    totalPacketsReceived = int(np.sum(flows['rxPackets']))
+    totalDelaySum = float(np.sum(flows['delaySum']))
+
+    duration = (flows['timeLastRxPacket']-flows['timeFirstRxPacket'])*1e-9
+    totalThroughPut = np.sum(flows['rxBytes']*8 / duration)
+
+    totalThroughPut = round(totalThroughPut/1024)
+    e2eDelay = round((totalDelaySum/totalPacketsReceived)/1000)
+    deliveryRatio = round((totalPacketsReceived / totalPacketsSent)*100, 2)
+    dropRatio = round(((totalPacketsSent-totalPacketsReceived) / totalPacketsSent)*100, 2)
+
+    return totalThroughPut, e2eDelay, deliveryRatio, dropRatio
+
 
 for f in os.listdir():
-    if f.endswith(".flowmonitor"):
+    if f.endswith(".flowmonitor") or f.endswith(".flowstats"):
         l = f.split(".")[0]
         l = l.split("-")
+        # runs with several gateways end in -gwN
+        gateways = int(l.pop()[2:]) if l[-1].startswith("gw") else 1
         nodes = int(l[1].strip())
         flows = int(l[2].strip())
         pkt_ps = int(l[3].strip())
 
         path = os.path.join(os.getcwd(), f)
-        result = process(path)
+        result = process(path) if f.endswith(".flowmonitor") else process_flowstats(path)
 
         row = {'Nodes': nodes, 'Flows': flows, 'Packets Per Second': pkt_ps, 
-               'Throughput': result[0], 'End to End Delay': result[1], 
+               'Gateways': gateways, 'Throughput': result[0], 'End to End Delay': result[1], 
                'Delivery Ratio': result[2], 'Drop Ratio': result[3]}
 
         df = df.append(pd.Series(row), ignore_index=True)
@@ -0,0 +1,98 @@
+import os
+import re
+import bisect
+import struct
+from collections import defaultdict
+
+# Joins the per-rank <prefix>-rank<r>.flowlog files of a `wired --distributed`
+# run into the <prefix>.flowstats file a single process FlowMonitor writes,
+# so processFlowA_wired.py handles distributed runs unchanged.
+#
+# A packet is identified across ranks by its five-tuple and IPv4
+# identification. Flow ids follow FlowMonitor's, i.e. the order of the
+# flows' first transmissions. lostPackets counts packets not delivered
+# 10s (FlowMonitor's MaxPerHopDelay) before the end, drops included, and
+# timesForwarded is not logged.
+
+MAX_PER_HOP_DELAY = 10 * 10**9
+
+# column order of the .flowstats files written by FlowStatsFile::Serialize
+FLOWSTATS_COLUMNS = ['flowId', 'timeFirstTxPacket', 'timeFirstRxPacket', 'timeLastTxPacket',
+                     'timeLastRxPacket', 'delaySum', 'jitterSum', 'lastDelay', 'txBytes',
+                     'rxBytes', 'txPackets', 'rxPackets', 'lostPackets', 'timesForwarded']
+
+def read_logs(paths):
+    tx = defaultdict(list)
+    rx = defaultdict(list)
+    end = 0
+    for path in paths:
+        tuples = {}
+        with open(path) as f:
+            for line in f:
+                l = line.split()
+                if l[0] == 'flow':
+                    tuples[l[1]] = tuple(l[2:])
+                elif l[0] == 'tx' or l[0] == 'rx':
+                    events = tx if l[0] == 'tx' else rx
+                    events[tuples[l[1]]].append((int(l[3]), int(l[2]), int(l[4])))
+                elif l[0] == 'end':
+                    end = max(end, int(l[1]))
+    return tx, rx, end
+
+def flow_stats(sent, received, end):
+    sent.sort()
+    received.sort()
+
+    # transmissions of each IPv4 id in time order; a delivery belongs to
+    # the latest one sent before it
+    sentById = defaultdict(list)
+    for time, ipId, size in sent:
+        sentById[ipId].append(time)
+    matched = set()
+
+    s = dict.fromkeys(FLOWSTATS_COLUMNS, 0)
+    s['timeFirstTxPacket'] = sent[0][0]
+    s['timeLastTxPacket'] = sent[-1][0]
+    s['txPackets'] = len(sent)
+    s['txBytes'] = sum(size for time, ipId, size in sent)
+
+    for time, ipId, size in received:
+        times = sentById.get(ipId, [])
+        i = bisect.bisect_right(times, time) - 1
+        if i < 0:
+            continue
+        matched.add((ipId, times[i]))
+        delay = time - times[i]
+        if s['rxPackets'] == 0:
+            s['timeFirstRxPacket'] = time
+        else:
+            s['jitterSum'] += abs(delay - s['lastDelay'])
+        s['timeLastRxPacket'] = time
+        s['delaySum'] += delay
+        s['lastDelay'] = delay
+        s['rxPackets'] += 1
+        s['rxBytes'] += size
+
+    s['lostPackets'] = sum(1 for time, ipId, size in sent
+                           if (ipId, time) not in matched and end - time >= MAX_PER_HOP_DELAY)
+    return s
+
+def write_flowstats(path, flows):
+    with open(path, 'wb') as f:
+        f.write(struct.pack('<8sIIQQ', b'NS3FLOWS', 1, len(FLOWSTATS_COLUMNS), len(flows), 0))
+        for column in FLOWSTATS_COLUMNS:
+            f.write(struct.pack('<%dq' % len(flows), *[flow[column] for flow in flows]))
+
+groups = defaultdict(list)
+for f in os.listdir():
+    m = re.match(r'(.*)-rank\d+\.flowlog$', f)
+    if m:
+        groups[m.group(1)].append(f)
+
+for prefix, paths in groups.items():
+    tx, rx, end = read_logs(paths)
+    flows = [flow_stats(tx[t], rx.get(t, []), end) for t in tx]
+    flows.sort(key=lambda flow: flow['timeFirstTxPacket'])
+    for i, flow in enumerate(flows):
+        flow['flowId'] = i + 1
+    write_flowstats(prefix + ".flowstats", flows)
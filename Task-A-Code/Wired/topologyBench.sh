@@ -0,0 +1,11 @@
+#!/bin/bash
+
+# construction, address assignment and routing cost of the generated
+# topology; 100 hosts per LAN, up to 20k nodes
+for routing in global lan; do
+    for topology in ring tree mesh; do
+        for routers in 10 50 100 200; do
+            ./waf --run "scratch/wired --benchmarkTopology=1 --routing=$routing --topology=$topology --n_routers=$routers --lan_hosts=100"
+        done
+    done
+done
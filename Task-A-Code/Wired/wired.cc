@@ -5,28 +5,52 @@
 #include "ns3/csma-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/flow-monitor-helper.h"
+#include "ns3/sweep-runner.h"
+#include "ns3/flow-stats-file.h"
+#include "ns3/flow-metrics-aggregator.h"
+#include "ns3/distributed-flow-log.h"
+#include "ns3/lan-routing-helper.h"
+#include "ns3/packet-buffer-pool.h"
+#include "ns3/flow-placement.h"
+#include "ns3/convergence-monitor.h"
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
 #include <vector>
+#include <algorithm>
 #include <string>
 #include <cstdlib>
-#include <ctime>
+#include <chrono>
+#include <sys/resource.h>
 using namespace std;
 using namespace ns3;
 
 /*
+    n_routers routers, each with a CSMA LAN behind it, interconnected as a
+    full mesh (the default; with 3 routers the original topology), a ring
+    or a binary tree:
+
     CSMA0 --- R0 ---- R2 --- CSMA2
                 \    /
                  \  /
                   R1 --- CSMA1
 */
 
-uint n_flows=20, n_nodes=40, n_routers=3, n_csma0, n_csma1, n_csma2;
+uint n_flows=20, n_nodes=40, n_routers=3, lan_hosts=0;
 uint start_time=0, stop_time, duration=60, pkts_ps=100, pkt_sz=1024;
-uint sinkPort=9;
-bool verbose = false;
-NodeContainer routers, csmaNodes0, csmaNodes1, csmaNodes2;
-NetDeviceContainer r0r1Net, r0r2Net, r1r2Net, csma0Net, csma1Net, csma2Net;
-Ipv4InterfaceContainer r0r1Addr, r0r2Addr, r1r2Addr, csma0Addr, csma1Addr, csma2Addr;
-string filePrefix, congestionAlgo = "TcpNewReno", recoveryAlgo="ns3::TcpClassicRecovery";
+uint sinkPort=9, seed=0, rank=0, n_ranks=1;
+double convergeTarget=0, convergeInterval=1;
+bool verbose = false, distributed = false, nullMessage = false, benchmarkTopology = false, profile = false, benchmarkScheduler = false, packetPool = false;
+// lans[i] is router i followed by its n_csma[i] hosts
+vector<uint> n_csma;
+vector<pair<uint, uint>> routerLinks;
+NodeContainer routers;
+vector<NodeContainer> lans;
+vector<NetDeviceContainer> linkNets, lanNets;
+vector<Ipv4InterfaceContainer> linkAddrs, lanAddrs;
+ApplicationContainer sourceApplications;
+string filePrefix, summaryCsv, flowFormat = "bin", topology = "mesh", routing = "global", routeCache, scheduler = "Map", traffic = "uniform", congestionAlgo = "TcpNewReno", recoveryAlgo="ns3::TcpClassicRecovery";
+chrono::steady_clock::time_point phaseStart;
 
 void processArguments(int argc, char** argv) {
     CommandLine cmd (__FILE__);
@@ -35,11 +59,85 @@ void processArguments(int argc, char** argv) {
     cmd.AddValue ("pkts_ps", "Packets Per Second", pkts_ps);
     cmd.AddValue ("pkt_sz", "Packets Size", pkt_sz);
     cmd.AddValue ("n_nodes", "Number of Nodes", n_nodes);
+    cmd.AddValue ("n_routers", "Number of Routers (One LAN Each)", n_routers);
+    cmd.AddValue ("lan_hosts", "Hosts Per LAN (0 = n_nodes/n_routers)", lan_hosts);
+    cmd.AddValue ("topology", "Router Interconnect (mesh, ring or tree)", topology);
+    cmd.AddValue ("routing", "Routing Setup (global or lan)", routing);
+    cmd.AddValue ("routeCache", "Directory Sharing lan Routes Between Runs", routeCache);
+    cmd.AddValue ("benchmarkTopology", "Time Topology Construction And Exit", benchmarkTopology);
     cmd.AddValue ("verbose", "Print In Console", verbose);
     cmd.AddValue ("duration", "Duration", duration);
+    cmd.AddValue ("flowFormat", "FlowMonitor Output (bin or xml)", flowFormat);
+    cmd.AddValue ("summaryCsv", "Append Run Metrics To CSV", summaryCsv);
+    cmd.AddValue ("seed", "Flow Placement Seed (0 = RngRun)", seed);
+    cmd.AddValue ("traffic", "Traffic Matrix (uniform, hotspot[:lan[:fraction]] or gravity)", traffic);
+    cmd.AddValue ("distributed", "Split The LANs Over MPI Ranks", distributed);
+    cmd.AddValue ("nullMessage", "Null Message Instead Of Granted Time Window Sync", nullMessage);
+    cmd.AddValue ("profile", "Print Per-Source Event Counts And Wall Time At Destroy", profile);
+    cmd.AddValue ("scheduler", "Event Scheduler (Map, Heap, List, Calendar, Ladder)", scheduler);
+    cmd.AddValue ("benchmarkScheduler", "Print Events/s And Peak Memory Of The Run", benchmarkScheduler);
+    cmd.AddValue ("packetPool", "Pool Packet, Tag And Event Allocations While Running", packetPool);
+    cmd.AddValue ("convergeTarget", "Stop Once The Throughput And Delay 95% CIs Are Within This Fraction (0 = Off)", convergeTarget);
+    cmd.AddValue ("convergeInterval", "Convergence Sampling Interval In Seconds", convergeInterval);
     cmd.Parse (argc, argv);
 
-    if( n_nodes<10 ) {
+    if( distributed ) {
+#ifdef NS3_MPI
+        GlobalValue::Bind ("SimulatorImplementationType",
+                           StringValue (nullMessage ? "ns3::NullMessageSimulatorImpl" : "ns3::DistributedSimulatorImpl"));
+        MpiInterface::Enable (&argc, &argv);
+        rank = MpiInterface::GetSystemId ();
+        n_ranks = MpiInterface::GetSize ();
+#else
+        std::cout << "Distributed Runs Need ns-3 Built With --enable-mpi\n";
+        exit(0);
+#endif
+    }
+    // reproducible, the same on every rank, and independent across replications
+    if( seed==0 ) seed = RngSeedManager::GetRun ();
+
+    if( profile && distributed ) {
+        std::cout << "Profiling Distributed Runs Not Supported\n";
+        exit(0);
+    }
+    else if( profile ) GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::ProfilingSimulatorImpl"));
+
+    TypeId schedulerType;
+    if( !TypeId::LookupByNameFailSafe ("ns3::"+scheduler+"Scheduler", &schedulerType) ) {
+        std::cout << "Unknown Scheduler " << scheduler << "\n";
+        exit(0);
+    }
+    GlobalValue::Bind ("SchedulerType", TypeIdValue (schedulerType));
+
+    if( convergeTarget>0 && distributed ) {
+        std::cout << "Convergence Stopping Of Distributed Runs Not Supported\n";
+        exit(0);
+    }
+
+    if( lan_hosts>0 ) n_nodes = lan_hosts*n_routers;
+    string trafficMatrix = traffic.substr(0, traffic.find(':'));
+
+    if( n_routers<2 ) {
+        std::cout << "Minimum 2 Routers Required\n";
+        exit(0);
+    }
+    else if( topology!="mesh" && topology!="ring" && topology!="tree" ) {
+        std::cout << "Unknown Topology " << topology << "\n";
+        exit(0);
+    }
+    else if( routing!="global" && routing!="lan" ) {
+        std::cout << "Unknown Routing " << routing << "\n";
+        exit(0);
+    }
+    else if( trafficMatrix!="uniform" && trafficMatrix!="hotspot" && trafficMatrix!="gravity" ) {
+        std::cout << "Unknown Traffic Matrix " << traffic << "\n";
+        exit(0);
+    }
+    else if( n_nodes/n_routers<3 ) {
+        std::cout << "Minimum 3 Nodes Per Router Required\n";
+        exit(0);
+    }
+    else if( n_nodes<10 ) {
         std::cout << "Minimum 10 Nodes Required\n";
         exit(0);
     }
@@ -52,21 +150,23 @@ void processArguments(int argc, char** argv) {
         exit(0);
     }
 
-    std::cout << "\n--------------------------------------------------------------------------\n";
-    std::cout << "Nodes: " << n_nodes << ", Flows: " << n_flows << ", Packets PPS: " << pkts_ps;
-    std::cout << "\n--------------------------------------------------------------------------\n";
+    if( rank==0 ) {
+        std::cout << "\n--------------------------------------------------------------------------\n";
+        std::cout << "Nodes: " << n_nodes << ", Flows: " << n_flows << ", Packets PPS: " << pkts_ps;
+        std::cout << "\n--------------------------------------------------------------------------\n";
+    }
 
-    n_csma0 = n_csma1 = n_nodes/3;
-    n_csma2 = n_nodes - (n_csma0 + n_csma1);
+    // the last LAN takes the remainder
+    n_csma.assign(n_routers, n_nodes/n_routers);
+    n_csma[n_routers-1] = n_nodes - (n_routers-1)*(n_nodes/n_routers);
 
     if(verbose) LogComponentEnable("PacketSink", LOG_LEVEL_INFO);
 
     stop_time = start_time + duration + 2;
 
-    filePrefix = "w-"+to_string(n_nodes)+"-"+to_string(n_flows)+"-"+to_string(pkts_ps); 
+    filePrefix = "w-"+to_string(n_nodes)+"-"+to_string(n_flows)+"-"+to_string(pkts_ps);
 
-    congestionAlgo = "ns3::" + congestionAlgo;
-    Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue (congestionAlgo));
+    Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue ("ns3::" + congestionAlgo));
     Config::SetDefault ("ns3::TcpL4Protocol::RecoveryType", StringValue (recoveryAlgo));  
     Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (1 << 21));
     Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (1 << 21));
@@ -75,72 +175,120 @@ void processArguments(int argc, char** argv) {
     Config::SetDefault ("ns3::FifoQueueDisc::MaxSize", QueueSizeValue (QueueSize ("100p")));
 }
 
+// each CSMA LAN and its router run on one rank; only the router links
+// (0.01ms, the lookahead) cross ranks
+uint lanRank(uint lan) {
+    return lan % n_ranks;
+}
+
+bool isLocal(Ptr<Node> node) {
+    return node->GetSystemId ()==rank;
+}
+
+void endPhase(string phase) {
+    if( benchmarkTopology ) {
+        chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - phaseStart;
+        std::cout << phase << ": " << elapsed.count() << " ms\n";
+    }
+    phaseStart = chrono::steady_clock::now();
+}
+
+void buildRouterLinks() {
+    routerLinks.clear();
+    if( topology=="mesh" ) {
+        for( uint i=0; i<n_routers; i++ )
+            for( uint j=i+1; j<n_routers; j++ ) routerLinks.push_back({i, j});
+    }
+    else if( topology=="ring" ) {
+        for( uint i=0; i+1<n_routers; i++ ) routerLinks.push_back({i, i+1});
+        if( n_routers>2 ) routerLinks.push_back({0, n_routers-1});
+    }
+    else if( topology=="tree" ) {
+        for( uint i=1; i<n_routers; i++ ) routerLinks.push_back({(i-1)/2, i});
+    }
+}
+
 void buildTopology() {
-    routers.Create (3);
-    csmaNodes0.Add(routers.Get(0));
-    csmaNodes0.Create(n_csma0);
-    csmaNodes1.Add(routers.Get(1));
-    csmaNodes1.Create(n_csma1);
-    csmaNodes2.Add(routers.Get(2));
-    csmaNodes2.Create(n_csma2);
+    phaseStart = chrono::steady_clock::now();
+
+    routers = NodeContainer ();
+    lans.assign(n_routers, NodeContainer ());
+    for( uint i=0; i<n_routers; i++ ) {
+        routers.Create (1, lanRank(i));
+        lans[i].Add(routers.Get(i));
+        lans[i].Create(n_csma[i], lanRank(i));
+    }
+    buildRouterLinks();
+    endPhase("Nodes");
 
     InternetStackHelper internet;
     internet.InstallAll ();
+    endPhase("Internet Stack");
 
     PointToPointHelper r2rHelper;
     r2rHelper.SetDeviceAttribute ("DataRate", StringValue ("2Mbps"));
     r2rHelper.SetChannelAttribute ("Delay", StringValue ("0.01ms"));
-    r0r1Net = r2rHelper.Install (routers.Get(0), routers.Get(1));
-    r0r2Net = r2rHelper.Install (routers.Get(0), routers.Get(2));
-    r1r2Net = r2rHelper.Install (routers.Get(1), routers.Get(2));
+    linkNets.clear();
+    for( pair<uint, uint> link : routerLinks )
+        linkNets.push_back(r2rHelper.Install (routers.Get(link.first), routers.Get(link.second)));
 
     CsmaHelper csmaHelper;
     csmaHelper.SetChannelAttribute ("DataRate", StringValue ("2Mbps"));
     csmaHelper.SetChannelAttribute ("Delay", TimeValue (NanoSeconds (6560)));
-    csma0Net = csmaHelper.Install (csmaNodes0);
-    csma1Net = csmaHelper.Install (csmaNodes1);
-    csma2Net = csmaHelper.Install (csmaNodes2);
+    lanNets.clear();
+    for( uint i=0; i<n_routers; i++ ) lanNets.push_back(csmaHelper.Install (lans[i]));
+    endPhase("Devices");
+
+    // the smallest subnet, at most a /24, that fits the largest LAN
+    uint maxLan = *max_element(n_csma.begin(), n_csma.end()) + 1, prefix = 24;
+    while( (1u << (32-prefix)) < maxLan+2 ) prefix--;
+    if( routerLinks.size() + n_routers > (1u << (prefix-8)) ) {
+        std::cout << "Too Many Subnets For 10.0.0.0/8\n";
+        exit(0);
+    }
 
+    Ipv4Mask mask (0xffffffff << (32-prefix));
     Ipv4AddressHelper ipv4;
-    ipv4.SetBase ("10.0.0.0", "255.255.255.0");
-
-    r0r1Addr = ipv4.Assign (r0r1Net);
-    ipv4.NewNetwork ();
-    r0r2Addr = ipv4.Assign (r0r2Net);
-    ipv4.NewNetwork ();
-    r1r2Addr = ipv4.Assign (r1r2Net);
-    ipv4.NewNetwork ();
-    csma0Addr = ipv4.Assign(csma0Net);
-    ipv4.NewNetwork ();
-    csma1Addr = ipv4.Assign(csma1Net);
-    ipv4.NewNetwork ();
-    csma2Addr = ipv4.Assign(csma2Net);
-
-    Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+    ipv4.SetBase ("10.0.0.0", mask);
+
+    linkAddrs.clear();
+    lanAddrs.clear();
+    for( NetDeviceContainer& net : linkNets ) {
+        linkAddrs.push_back(ipv4.Assign (net));
+        ipv4.NewNetwork ();
+    }
+    for( NetDeviceContainer& net : lanNets ) {
+        lanAddrs.push_back(ipv4.Assign (net));
+        ipv4.NewNetwork ();
+    }
+    endPhase("Addresses");
+
+    if( routing=="lan" ) {
+        LanRoutingHelper lanRouting;
+        lanRouting.SetCacheDirectory (routeCache);
+        for( uint i=0; i<routerLinks.size(); i++ )
+            lanRouting.AddRouterLink (routerLinks[i].first, routerLinks[i].second, linkNets[i], linkAddrs[i]);
+        for( uint i=0; i<n_routers; i++ ) lanRouting.AddLan (i, lanNets[i], lanAddrs[i], mask);
+        lanRouting.Populate (routers);
+    }
+    else Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+    endPhase("Routing");
 }
 
 void setUpSinks() {
-    for( uint i=1; i<n_csma0; i++ ) {
-        PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), sinkPort));
-        ApplicationContainer sinkApps = sinkHelper.Install(csmaNodes0.Get(i));
-        sinkApps.Start (Seconds (start_time));
-        sinkApps.Stop (Seconds (stop_time));
-    }
-    for( uint i=1; i<n_csma1; i++ ) {
-        PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), sinkPort));
-        ApplicationContainer sinkApps = sinkHelper.Install(csmaNodes1.Get(i));
-        sinkApps.Start (Seconds (start_time));
-        sinkApps.Stop (Seconds (stop_time));
-    }
-    for( uint i=1; i<n_csma2; i++ ) {
-        PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), sinkPort));
-        ApplicationContainer sinkApps = sinkHelper.Install(csmaNodes2.Get(i));
-        sinkApps.Start (Seconds (start_time+1));
-        sinkApps.Stop (Seconds (stop_time-1));
+    for( uint lan=0; lan<n_routers; lan++ ) {
+        for( uint i=1; i<n_csma[lan]; i++ ) {
+            if( !isLocal(lans[lan].Get(i)) ) continue;
+            PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), sinkPort));
+            ApplicationContainer sinkApps = sinkHelper.Install(lans[lan].Get(i));
+            sinkApps.Start (Seconds (start_time));
+            sinkApps.Stop (Seconds (stop_time));
+        }
     }
 }
 
 void startSourceApp(InetSocketAddress sinkAddress, NodeContainer sourceNode) {
+    if( !isLocal(sourceNode.Get(0)) ) return;
     OnOffHelper source ("ns3::TcpSocketFactory", sinkAddress);
     source.SetAttribute ("PacketSize", UintegerValue (pkt_sz));
     source.SetAttribute ("MaxBytes", UintegerValue (0));
@@ -148,104 +296,141 @@ void startSourceApp(InetSocketAddress sinkAddress, NodeContainer sourceNode) {
     ApplicationContainer sourceApps = source.Install (sourceNode);
     sourceApps.Start (Seconds (start_time+3));
     sourceApps.Stop (Seconds(stop_time-3));
+    sourceApplications.Add (sourceApps);
 }
 
-void setUpSources(uint csmaNo, uint n_src) {
-    uint sourceCsma=1, sinkCsma, sinkNode;
-    if( csmaNo==0 ) {
-        while(n_src>0) {
-            sinkCsma = rand()%2;
-            // sink is in CSMA 1
-            if( sinkCsma==0 ) {
-                sinkNode = rand()%(n_csma1-1)+1;
-                startSourceApp(InetSocketAddress (csma1Addr.GetAddress(sinkNode), sinkPort), 
-                               csmaNodes0.Get (sourceCsma));
-            }
-            // sink is in CSMA 2
-            else if( sinkCsma==1 ) {
-                sinkNode = rand()%(n_csma2-1)+1;
-                startSourceApp(InetSocketAddress (csma2Addr.GetAddress(sinkNode), sinkPort), 
-                               csmaNodes0.Get (sourceCsma));
-            }
-            
-            
-            if( sourceCsma==n_csma0-1 ) sourceCsma = 1;
-            else sourceCsma++;
-            n_src--;
-        }
-    }
-    else if( csmaNo==1 ) {
-        while(n_src>0) {
-            sinkCsma = rand()%2;
-            // sink is in CSMA 0
-            if( sinkCsma==0 ) {
-                sinkNode = rand()%(n_csma0-1)+1;
-                startSourceApp(InetSocketAddress (csma0Addr.GetAddress(sinkNode), sinkPort), 
-                               csmaNodes1.Get (sourceCsma));
-            }
-            // sink is in CSMA 2
-            else if( sinkCsma==1 ) {
-                sinkNode = rand()%(n_csma2-1)+1;
-                startSourceApp(InetSocketAddress (csma2Addr.GetAddress(sinkNode), sinkPort), 
-                               csmaNodes1.Get (sourceCsma));
-            }
-
-            if( sourceCsma==n_csma1-1 ) sourceCsma = 1;
-            else sourceCsma++;
-            n_src--;
-        }
-    }
-    else if( csmaNo==2 ) {
-        while(n_src>0) {
-            sinkCsma = rand()%2;
-            // sink is in CSMA 0
-            if( sinkCsma==0 ) {
-                sinkNode = rand()%(n_csma0-1)+1;
-                startSourceApp(InetSocketAddress (csma0Addr.GetAddress(sinkNode), sinkPort), 
-                               csmaNodes2.Get (sourceCsma));
-            }
-            // sink is in CSMA 1
-            else if( sinkCsma==1 ) {
-                sinkNode = rand()%(n_csma1-1)+1;
-                startSourceApp(InetSocketAddress (csma1Addr.GetAddress(sinkNode), sinkPort), 
-                               csmaNodes2.Get (sourceCsma));
-            }
-
-            if( sourceCsma==n_csma2-1 ) sourceCsma = 1;
-            else sourceCsma++;
-            n_src--;
-        }
+// at convergence, what the sources' stop at stop_time-3 would do
+void stopSources() {
+    for( uint i=0; i<sourceApplications.GetN(); i++ ) {
+        Ptr<Socket> socket = DynamicCast<OnOffApplication> (sourceApplications.Get (i))->GetSocket ();
+        if( socket ) socket->ShutdownSend ();
     }
 }
 
 void setUpFlows() {
     setUpSinks();
 
-    uint n_src_csma0, n_src_csma1, n_src_csma2;
-    n_src_csma0 = n_src_csma1 = n_flows/3;
-    n_src_csma2 = n_flows - (n_src_csma0+n_src_csma1);
+    // sources and sinks are hosts 1..n_csma-1 of each LAN
+    vector<uint32_t> hosts;
+    for( uint lan=0; lan<n_routers; lan++ ) hosts.push_back(n_csma[lan]-1);
+
+    FlowPlacement placement (seed);
+    placement.SetTrafficMatrix (traffic);
+    for( const FlowPair& flow : placement.Place(hosts, n_flows) ) {
+        startSourceApp(InetSocketAddress (lanAddrs[flow.dstGroup].GetAddress(flow.dstHost+1), sinkPort),
+                       lans[flow.srcGroup].Get (flow.srcHost+1));
+    }
+}
 
-    srand(time(NULL));
+// FlowMonitor can't follow packets across ranks: log them per rank and
+// merge the logs into <prefix>.flowstats with mergeFlowLogs.py
+void runDistributed() {
+    NodeContainer localNodes;
+    for( NodeList::Iterator it=NodeList::Begin(); it!=NodeList::End(); it++ )
+        if( isLocal(*it) ) localNodes.Add(*it);
 
-    setUpSources(0, n_src_csma0);
-    setUpSources(1, n_src_csma1);
-    setUpSources(2, n_src_csma2);
+    DistributedFlowLog flowLog (filePrefix+"-rank"+to_string(rank)+".flowlog");
+    flowLog.Install (localNodes);
+
+    Simulator::Stop (Seconds (stop_time));
+    if( packetPool ) PacketBufferPool::Enable ();
+    Simulator::Run ();
+    if( packetPool ) PacketBufferPool::Disable ();
+
+    if( packetPool ) PacketBufferPool::PrintStats (std::cout);
+
+    flowLog.Close ();
+    Simulator::Destroy ();
+#ifdef NS3_MPI
+    MpiInterface::Disable ();
+#endif
 }
 
-int main(int argc, char** argv) {
-    processArguments(argc, argv);
+// events/s and peak memory of the run, for schedulerBench.sh
+void printSchedulerStats(chrono::steady_clock::time_point runStart) {
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - runStart;
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << "Scheduler: " << scheduler << ", Events: " << Simulator::GetEventCount ()
+              << ", Run: " << elapsed.count() << " s, Events/s: " << Simulator::GetEventCount ()/elapsed.count()
+              << ", Max RSS: " << usage.ru_maxrss/1024 << " MB\n";
+}
+
+void runSimulation() {
     buildTopology();
+
+    if( benchmarkTopology ) {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        std::cout << "Routers: " << n_routers << ", Router Links: " << routerLinks.size()
+                  << ", Nodes: " << NodeList::GetNNodes() << ", Max RSS: " << usage.ru_maxrss/1024 << " MB\n";
+        Simulator::Destroy ();
+        return;
+    }
+
     setUpFlows();
 
+    if( distributed ) {
+        runDistributed();
+        return;
+    }
+
     FlowMonitorHelper flowHelper;
     flowHelper.InstallAll ();
 
+    ConvergenceMonitor convergence (flowHelper.GetMonitor ());
+    if( convergeTarget>0 ) {
+        convergence.SetTarget (convergeTarget);
+        convergence.SetInterval (Seconds (convergeInterval));
+        convergence.SetDrain (Seconds (3), MakeCallback (&stopSources));
+        convergence.Start (Seconds (start_time+3));
+    }
+
     Simulator::Stop (Seconds (stop_time));
+    chrono::steady_clock::time_point runStart = chrono::steady_clock::now();
+    // setup and post-processing allocate from malloc
+    if( packetPool ) PacketBufferPool::Enable ();
     Simulator::Run ();
+    if( packetPool ) PacketBufferPool::Disable ();
+
+    if( convergeTarget>0 ) convergence.PrintReport (std::cout);
 
-    flowHelper.SerializeToXmlFile (filePrefix+".flowmonitor", true, true);
+    if( benchmarkScheduler ) printSchedulerStats(runStart);
+    if( packetPool ) PacketBufferPool::PrintStats (std::cout);
+    if( SweepRunner::IsReplicating () ) {
+        FlowMetrics metrics = FlowMetricsAggregator (flowHelper.GetMonitor ()).Summarize ();
+        SweepRunner::Report ({{"Throughput", metrics.throughput}, {"Delay", metrics.delay}});
+    }
+
+    if( flowFormat=="xml" ) flowHelper.SerializeToXmlFile (filePrefix+".flowmonitor", true, true);
+    else FlowStatsFile::Serialize (flowHelper.GetMonitor (), filePrefix+".flowstats");
+
+    if( summaryCsv!="" ) {
+        FlowMetricsAggregator aggregator (flowHelper.GetMonitor ());
+        aggregator.AppendCsvRow (summaryCsv, {{"Nodes", to_string(n_nodes)}, {"Flows", to_string(n_flows)},
+                                              {"Packets Per Second", to_string(pkts_ps)}}, 0);
+    }
 
     Simulator::Destroy ();
+}
+
+void runPoint(int argc, char** argv) {
+    processArguments(argc, argv);
+    runSimulation();
+}
+
+int main(int argc, char** argv) {
+    SweepRunner sweep;
+    if( sweep.Parse(argc, argv) ) {
+        // the LAN and address state is built up for one run per process
+        if( sweep.GetBatch()>1 ) {
+            std::cout << "Batch Runs Not Supported\n";
+            return 0;
+        }
+        return sweep.Run(MakeCallback(&runPoint));
+    }
+
+    runPoint(argc, argv);
 
     return 0;
 }
\ No newline at end of file
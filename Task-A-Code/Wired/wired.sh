@@ -1,24 +1,20 @@
 #!/bin/bash
 
-rm *.flowmonitor
+rm *.flowmonitor *.flowstats
 
-declare -a nodes=(20, 40, 60, 80, 100)
-declare -a flows=(10, 20, 30, 40, 50)
-# declare -a pps=(100, 200, 300, 400, 500)
-declare -a pps=(10, 20, 30, 40, 50)
+nodes="20,40,60,80,100"
+flows="10,20,30,40,50"
+# pps="100,200,300,400,500"
+pps="10,20,30,40,50"
 
-for n in ${nodes[@]}; do
-    ./waf --run "scratch/wired --n_nodes=$n --n_flows=20 --pkts_ps=20 --duration=20"
-done
+./waf --run "scratch/wired --sweep=n_nodes=$nodes --n_flows=20 --pkts_ps=20 --duration=20 --routing=lan --routeCache=routes"
 
-for f in ${flows[@]}; do
-    ./waf --run "scratch/wired --n_nodes=60 --n_flows=$f --pkts_ps=20 --duration=20"
-done
+./waf --run "scratch/wired --sweep=n_flows=$flows --n_nodes=60 --pkts_ps=20 --duration=20 --routing=lan --routeCache=routes"
 
-for p in ${pps[@]}; do
-    ./waf --run "scratch/wired --n_nodes=60 --n_flows=30 --pkts_ps=$p --duration=20"
-done
+./waf --run "scratch/wired --sweep=pkts_ps=$pps --n_nodes=60 --n_flows=30 --duration=20 --routing=lan --routeCache=routes"
 
-python3 processFlowA_wired.py
+if [ -x ./processFlows ]; then ./processFlows --layout=wired; else python3 processFlowA_wired.py; fi
+
+rm -rf routes
 
 libreoffice --headless --convert-to xlsx:"Calc MS Excel 2007 XML" results.csv
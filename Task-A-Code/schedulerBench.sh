@@ -0,0 +1,30 @@
+#!/bin/bash
+
+# Events/s and peak memory of each event scheduler over the wpan.sh and
+# wired.sh grids. Points run one at a time so they don't compete for cores.
+# LadderScheduler is first checked against a reference queue by
+# ladder-scheduler-check (a scratch program from Task-B-Code).
+
+schedulers="Map Heap List Calendar Ladder"
+
+./waf --run "scratch/ladder-scheduler-check" || exit 1
+
+grids=(
+    "scratch/mywpan4 --sweep=n_nodes=2,4,6,8,10 --n_flows=4 --pkts_ps=200 --duration=100"
+    "scratch/mywpan4 --sweep=n_flows=2,6,10,14,18 --n_nodes=2 --pkts_ps=200 --duration=100"
+    "scratch/mywpan4 --sweep=pkts_ps=100,200,300,400,500 --n_nodes=2 --n_flows=5 --duration=100"
+    "scratch/wired --sweep=n_nodes=20,40,60,80,100 --n_flows=20 --pkts_ps=20 --duration=20 --routing=lan --routeCache=routes"
+    "scratch/wired --sweep=n_flows=10,20,30,40,50 --n_nodes=60 --pkts_ps=20 --duration=20 --routing=lan --routeCache=routes"
+    "scratch/wired --sweep=pkts_ps=100,200,300,400,500 --n_nodes=60 --n_flows=30 --duration=20 --routing=lan --routeCache=routes"
+)
+
+for grid in "${grids[@]}"; do
+    echo "$grid"
+    for scheduler in $schedulers; do
+        ./waf --run "$grid --jobs=1 --scheduler=$scheduler --benchmarkScheduler=1" | grep "^Scheduler:" |
+        awk -F'[:,] *' -v s=$scheduler '{ events += $4; run += $6; if( $10+0 > rss ) rss = $10+0 }
+            END { printf "  %-8s %12.0f events/s  %6.0f MB peak RSS\n", s, events/run, rss }'
+    done
+done
+
+rm -rf routes *.flowmonitor *.flowstats
@@ -0,0 +1,169 @@
+#include "convergence-monitor.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ConvergenceMonitor");
+
+const uint32_t ConvergenceMonitor::Batches;
+const uint32_t ConvergenceMonitor::MinBatchSize;
+
+// two-sided 95% quantile of Student's t with Batches - 1 degrees of freedom
+static const double T95 = 2.262;
+// batch means further apart than this are taken as correlated
+static const double MaxLag1 = 0.3;
+
+ConvergenceMonitor::ConvergenceMonitor (Ptr<FlowMonitor> monitor)
+  : m_monitor (monitor),
+    m_interval (Seconds (1)),
+    m_target (0.05),
+    m_converged (false),
+    m_drain (Seconds (0)),
+    m_lastRxBytes (0),
+    m_lastRxPackets (0),
+    m_lastDelaySum (0),
+    m_started (false),
+    m_throughputEstimate {0, INFINITY, 0},
+    m_delayEstimate {0, INFINITY, 0}
+{
+  NS_LOG_FUNCTION (this << monitor);
+}
+
+void
+ConvergenceMonitor::SetInterval (Time interval)
+{
+  m_interval = interval;
+}
+
+void
+ConvergenceMonitor::SetTarget (double target)
+{
+  m_target = target;
+}
+
+void
+ConvergenceMonitor::SetDrain (Time drain, Callback<void> stopSources)
+{
+  m_drain = drain;
+  m_stopSources = stopSources;
+}
+
+void
+ConvergenceMonitor::Start (Time at)
+{
+  NS_LOG_FUNCTION (this << at);
+  Simulator::Schedule (at - Simulator::Now (), &ConvergenceMonitor::Sample, this);
+}
+
+bool
+ConvergenceMonitor::IsConverged () const
+{
+  return m_converged;
+}
+
+void
+ConvergenceMonitor::Sample ()
+{
+  uint64_t rxBytes = 0, rxPackets = 0;
+  int64_t delaySum = 0;
+  const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+  uint32_t forwardFlows = (stats.size () + 1) / 2, i = 0;
+  for (FlowMonitor::FlowStatsContainerCI it = stats.begin (); i < forwardFlows; it++, i++)
+    {
+      rxBytes += it->second.rxBytes;
+      rxPackets += it->second.rxPackets;
+      delaySum += it->second.delaySum.GetNanoSeconds ();
+    }
+
+  // the first sample only sets the baseline
+  if (m_started)
+    {
+      m_throughput.push_back ((rxBytes - m_lastRxBytes) * 8 / m_interval.GetSeconds () / 1024);
+      if (rxPackets > m_lastRxPackets)
+        {
+          m_delay.push_back (double (delaySum - m_lastDelaySum) / (rxPackets - m_lastRxPackets) / 1000);
+        }
+    }
+  m_started = true;
+  m_lastRxBytes = rxBytes;
+  m_lastRxPackets = rxPackets;
+  m_lastDelaySum = delaySum;
+
+  if (BatchMeans (m_throughput, m_throughputEstimate) && BatchMeans (m_delay, m_delayEstimate)
+      && IsSteady (m_throughputEstimate) && IsSteady (m_delayEstimate))
+    {
+      NS_LOG_INFO ("Converged after " << m_throughput.size () << " samples");
+      m_converged = true;
+      m_convergedAt = Simulator::Now ();
+      if (!m_stopSources.IsNull ())
+        {
+          m_stopSources ();
+        }
+      Simulator::Stop (m_drain);
+      return;
+    }
+  Simulator::Schedule (m_interval, &ConvergenceMonitor::Sample, this);
+}
+
+bool
+ConvergenceMonitor::BatchMeans (const std::vector<double> &series, Estimate &estimate) const
+{
+  uint32_t size = series.size () / (Batches + 1);
+  if (size < MinBatchSize)
+    {
+      return false;
+    }
+
+  // the first batch, and the samples left over, are the warm-up
+  std::vector<double> means (Batches, 0);
+  uint32_t first = series.size () - Batches * size;
+  for (uint32_t i = 0; i < Batches * size; i++)
+    {
+      means[i / size] += series[first + i] / size;
+    }
+
+  double mean = 0, squares = 0, lag = 0;
+  for (double m : means)
+    {
+      mean += m / Batches;
+    }
+  for (uint32_t b = 0; b < Batches; b++)
+    {
+      squares += (means[b] - mean) * (means[b] - mean);
+      if (b > 0)
+        {
+          lag += (means[b] - mean) * (means[b - 1] - mean);
+        }
+    }
+  estimate.mean = mean;
+  estimate.halfWidth = T95 * std::sqrt (squares / (Batches - 1) / Batches);
+  estimate.lag1 = squares > 0 ? lag / squares : 0;
+  return true;
+}
+
+bool
+ConvergenceMonitor::IsSteady (const Estimate &estimate) const
+{
+  return estimate.mean != 0 && estimate.halfWidth <= m_target * std::fabs (estimate.mean)
+         && estimate.lag1 <= MaxLag1;
+}
+
+void
+ConvergenceMonitor::PrintReport (std::ostream &os) const
+{
+  if (m_converged)
+    {
+      os << "Converged at " << m_convergedAt.GetSeconds () << " s";
+    }
+  else
+    {
+      os << "Not Converged";
+    }
+  os << " after " << m_throughput.size () << " samples: Throughput " << m_throughputEstimate.mean
+     << " +- " << m_throughputEstimate.halfWidth << " kbps, Delay " << m_delayEstimate.mean
+     << " +- " << m_delayEstimate.halfWidth << " us\n";
+}
+
+} // namespace ns3
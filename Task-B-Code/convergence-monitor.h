@@ -0,0 +1,88 @@
+#ifndef CONVERGENCEMONITOR_H
+#define CONVERGENCEMONITOR_H
+
+#include "ns3/callback.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/nstime.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Stops a run once its throughput and delay have reached steady state.
+ *
+ * Every interval, the monitor takes the throughput and mean delay of the
+ * forward flows (the first half by FlowId, as FlowMetricsAggregator) over
+ * that interval alone.  The series is tested by batch means: it is cut
+ * into Batches + 1 equal batches, the first of which is dropped as the
+ * warm-up, and the 95% confidence interval of the mean is computed from
+ * the batch means.  Once both metrics' intervals are within the relative
+ * target, and the batch means' lag-1 autocorrelation is low enough for
+ * the batches to count as independent, the sources are stopped and the
+ * simulator stops after the drain time, as at the end of a full run.
+ *
+ * Each test is O(samples), and a sample is O(flows), once per interval.
+ */
+class ConvergenceMonitor {
+public:
+  static const uint32_t Batches = 10;
+  static const uint32_t MinBatchSize = 3;
+
+  ConvergenceMonitor (Ptr<FlowMonitor> monitor);
+
+  /** Sampling interval, 1 s by default. */
+  void SetInterval (Time interval);
+
+  /** Relative half width of the 95% intervals to stop at, 0.05 by default. */
+  void SetTarget (double target);
+
+  /**
+   * On convergence, call stopSources and let the packets in flight arrive
+   * for drain before stopping, as the scenario's sources stop before its
+   * stop time.  Otherwise FlowMonitor counts them as sent and never
+   * received.  Without a drain the simulator stops at once.
+   */
+  void SetDrain (Time drain, Callback<void> stopSources);
+
+  /** Take the first sample at this (absolute) time, e.g. when the sources start. */
+  void Start (Time at);
+
+  bool IsConverged () const;
+
+  /** One line: converged or not, when, and each metric's mean +- half width. */
+  void PrintReport (std::ostream &os) const;
+
+private:
+  struct Estimate {
+    double mean;
+    double halfWidth;
+    double lag1;
+  };
+
+  void Sample ();
+  /** \return false if there are too few samples for the test */
+  bool BatchMeans (const std::vector<double> &series, Estimate &estimate) const;
+  bool IsSteady (const Estimate &estimate) const;
+
+  Ptr<FlowMonitor> m_monitor;
+  Time m_interval;
+  double m_target;
+  bool m_converged;
+  Time m_convergedAt;
+  Time m_drain;
+  Callback<void> m_stopSources;
+
+  uint64_t m_lastRxBytes;
+  uint64_t m_lastRxPackets;
+  int64_t m_lastDelaySum;
+  bool m_started;
+
+  std::vector<double> m_throughput;   //!< kbit/s (1024 bit) per interval
+  std::vector<double> m_delay;        //!< us, per interval that received packets
+  Estimate m_throughputEstimate;
+  Estimate m_delayEstimate;
+};
+
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include "cwnd-trace-recorder.h"
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+#include <chrono>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CwndTraceRecorder");
+
+CwndTraceRecorder *CwndTraceRecorder::s_recorder = 0;
+uint64_t CwndTraceRecorder::s_generations = 0;
+
+CwndTraceRing::CwndTraceRing (uint32_t flow, uint32_t capacity)
+  : m_flow (flow),
+    m_mask (capacity - 1),
+    m_records (capacity),
+    m_head (0),
+    m_tail (0)
+{
+}
+
+void
+CwndTraceRing::Drain (std::vector<CwndTraceRecord> &out)
+{
+  uint64_t tail = m_tail.load (std::memory_order_relaxed);
+  uint64_t head = m_head.load (std::memory_order_acquire);
+  for (; tail != head; tail++)
+    {
+      out.push_back (m_records[tail & m_mask]);
+    }
+  m_tail.store (tail, std::memory_order_release);
+}
+
+void
+CwndTraceRecorder::Enable (std::string fileName, uint32_t ringSize)
+{
+  NS_LOG_FUNCTION (fileName << ringSize);
+  if (ringSize == 0 || (ringSize & (ringSize - 1)))
+    {
+      NS_FATAL_ERROR ("Cwnd trace ring size " << ringSize << " is not a power of two");
+    }
+  Disable ();
+  s_recorder = new CwndTraceRecorder (fileName, ringSize);
+}
+
+void
+CwndTraceRecorder::Disable ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  CwndTraceRecorder *recorder = s_recorder;
+  s_recorder = 0;
+  delete recorder;
+}
+
+CwndTraceRecorder::CwndTraceRecorder (std::string fileName, uint32_t ringSize)
+  : m_generation (++s_generations),
+    m_ringSize (ringSize),
+    m_running (true)
+{
+  m_file = std::fopen (fileName.c_str (), "wb");
+  if (m_file == 0)
+    {
+      NS_FATAL_ERROR ("Can't open file " << fileName);
+    }
+  char magic[8] = {'N', 'S', '3', 'C', 'W', 'N', 'D', 0};
+  uint32_t version = 1, recordSize = sizeof (CwndTraceRecord);
+  std::fwrite (magic, sizeof (magic), 1, m_file);
+  std::fwrite (&version, sizeof (version), 1, m_file);
+  std::fwrite (&recordSize, sizeof (recordSize), 1, m_file);
+
+  m_writer = std::thread (&CwndTraceRecorder::WriterLoop, this);
+}
+
+CwndTraceRecorder::~CwndTraceRecorder ()
+{
+  m_running.store (false, std::memory_order_release);
+  m_writer.join ();
+  std::fclose (m_file);
+  NS_LOG_INFO ("Closed cwnd trace of " << m_rings.size () << " flows");
+}
+
+CwndTraceRing *
+CwndTraceRecorder::CreateRing ()
+{
+  std::lock_guard<std::mutex> lock (m_ringsLock);
+  m_rings.emplace_back (new CwndTraceRing (m_rings.size (), m_ringSize));
+  return m_rings.back ().get ();
+}
+
+bool
+CwndTraceRecorder::DrainAll (std::vector<CwndTraceRecord> &buffer)
+{
+  buffer.clear ();
+  {
+    std::lock_guard<std::mutex> lock (m_ringsLock);
+    for (std::unique_ptr<CwndTraceRing> &ring : m_rings)
+      {
+        ring->Drain (buffer);
+      }
+  }
+  if (!buffer.empty ())
+    {
+      std::fwrite (buffer.data (), sizeof (CwndTraceRecord), buffer.size (), m_file);
+    }
+  return !buffer.empty ();
+}
+
+void
+CwndTraceRecorder::WriterLoop ()
+{
+  std::vector<CwndTraceRecord> buffer;
+  while (m_running.load (std::memory_order_acquire))
+    {
+      if (!DrainAll (buffer))
+        {
+          std::this_thread::sleep_for (std::chrono::milliseconds (1));
+        }
+    }
+  // the simulation thread has stopped pushing by now
+  DrainAll (buffer);
+}
+
+} // namespace ns3
@@ -0,0 +1,114 @@
+#ifndef CWNDTRACERECORDER_H
+#define CWNDTRACERECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * One congestion window sample, as stored in a .cwnd file.
+ */
+struct CwndTraceRecord {
+  enum Event : uint8_t { ACK, LOSS };
+
+  int64_t time;        //!< simulation time, ns
+  uint32_t flow;       //!< in order of each flow's first record
+  uint32_t cWnd;
+  uint32_t ssThresh;
+  uint32_t cwMax;
+  uint32_t idealCw;
+  uint8_t event;
+  uint8_t pad[3];
+};
+
+static_assert (sizeof (CwndTraceRecord) == 32, "CwndTraceRecord must stay 32 bytes");
+
+/**
+ * Single producer, single consumer ring of CwndTraceRecords for one flow.
+ * The simulation thread pushes and the recorder's writer thread drains.
+ */
+class CwndTraceRing {
+public:
+  CwndTraceRing (uint32_t flow, uint32_t capacity);
+
+  uint32_t GetFlow () const { return m_flow; }
+
+  /** Waits for the writer if the ring is full, so no sample is lost. */
+  void Push (const CwndTraceRecord &record)
+  {
+    uint64_t head = m_head.load (std::memory_order_relaxed);
+    while (head - m_tail.load (std::memory_order_acquire) == m_records.size ())
+      {
+        std::this_thread::yield ();
+      }
+    m_records[head & m_mask] = record;
+    m_head.store (head + 1, std::memory_order_release);
+  }
+
+  /** Append everything pushed so far to out. */
+  void Drain (std::vector<CwndTraceRecord> &out);
+
+private:
+  uint32_t m_flow;
+  uint64_t m_mask;
+  std::vector<CwndTraceRecord> m_records;
+  std::atomic<uint64_t> m_head;
+  std::atomic<uint64_t> m_tail;
+};
+
+/**
+ * Binary cwnd tracing for congestion control algorithms.
+ *
+ * While enabled, each flow gets a preallocated CwndTraceRing, and a
+ * writer thread drains the rings into the file.  The file starts with
+ * a 16 byte header ("NS3CWND", then uint32 version and record size),
+ * followed by CwndTraceRecords.  Each flow's records appear in order, but
+ * records of different flows are interleaved.  When tracing is disabled,
+ * a traced algorithm only tests one static pointer per call.
+ */
+class CwndTraceRecorder {
+public:
+  /** Start tracing to fileName, with ringSize (a power of two) records per flow. */
+  static void Enable (std::string fileName, uint32_t ringSize = 4096);
+
+  /** Flush everything, stop the writer thread and close the file. */
+  static void Disable ();
+
+  static CwndTraceRecorder *Get () { return s_recorder; }
+
+  /** Differs between successive Enable calls, so rings are never reused across them. */
+  uint64_t GetGeneration () const { return m_generation; }
+
+  /** Called from the simulation thread for each new flow. */
+  CwndTraceRing *CreateRing ();
+
+  ~CwndTraceRecorder ();
+
+private:
+  CwndTraceRecorder (std::string fileName, uint32_t ringSize);
+  void WriterLoop ();
+  bool DrainAll (std::vector<CwndTraceRecord> &buffer);
+
+  static CwndTraceRecorder *s_recorder;
+  static uint64_t s_generations;
+
+  uint64_t m_generation;
+
+  std::FILE *m_file;
+  uint32_t m_ringSize;
+  std::mutex m_ringsLock;
+  std::vector<std::unique_ptr<CwndTraceRing> > m_rings;
+  std::atomic<bool> m_running;
+  std::thread m_writer;
+};
+
+}
+
+#endif
@@ -0,0 +1,24 @@
+import os
+import numpy as np
+import pandas as pd
+
+# layout of the CwndTraceRecords in the .cwnd files written by mywpanB --cwndTrace
+CWND_RECORD = np.dtype([('time', '<i8'), ('flow', '<u4'), ('cWnd', '<u4'), ('ssThresh', '<u4'),
+                        ('cwMax', '<u4'), ('idealCw', '<u4'), ('event', 'u1'), ('pad', 'V3')])
+
+def load_cwnd(path):
+    magic = np.fromfile(path, dtype='S8', count=1)[0]
+    if magic != b'NS3CWND':
+        raise ValueError(path + " is not a .cwnd file")
+    records = np.fromfile(path, dtype=CWND_RECORD, offset=16)
+    # each flow's records are in order, but flows are interleaved
+    return records[np.lexsort((records['time'], records['flow']))]
+
+for f in os.listdir():
+    if f.endswith(".cwnd"):
+        records = load_cwnd(f)
+        df = pd.DataFrame({'Flow': records['flow'], 'Time': records['time']*1e-9,
+                           'Event': np.where(records['event'] == 0, 'ack', 'loss'),
+                           'Cwnd': records['cWnd'], 'Ssthresh': records['ssThresh'],
+                           'CW_MAX': records['cwMax'], 'Ideal_CW': records['idealCw']})
+        df.to_csv(f[:-len(".cwnd")] + "-cwnd.csv", index=False)
@@ -0,0 +1,94 @@
+#include "distributed-flow-log.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DistributedFlowLog");
+
+DistributedFlowLog::DistributedFlowLog (std::string fileName)
+  : m_classifier (Create<Ipv4FlowClassifier> ()),
+    m_nFlows (0)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  m_os.open (fileName.c_str (), std::ios::out | std::ios::trunc);
+  if (!m_os.is_open ())
+    {
+      NS_FATAL_ERROR ("Can't open file " << fileName);
+    }
+}
+
+DistributedFlowLog::~DistributedFlowLog ()
+{
+  Close ();
+}
+
+void
+DistributedFlowLog::Install (NodeContainer nodes)
+{
+  NS_LOG_FUNCTION (this);
+  for (NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); it++)
+    {
+      Ptr<Ipv4L3Protocol> ipv4 = (*it)->GetObject<Ipv4L3Protocol> ();
+      if (ipv4 == 0)
+        {
+          continue;
+        }
+      ipv4->TraceConnectWithoutContext ("SendOutgoing",
+                                        MakeCallback (&DistributedFlowLog::SendOutgoing, this));
+      ipv4->TraceConnectWithoutContext ("LocalDeliver",
+                                        MakeCallback (&DistributedFlowLog::LocalDeliver, this));
+    }
+}
+
+void
+DistributedFlowLog::Close ()
+{
+  if (m_os.is_open ())
+    {
+      m_os << "end " << Simulator::Now ().GetNanoSeconds () << "\n";
+      m_os.close ();
+    }
+}
+
+void
+DistributedFlowLog::SendOutgoing (const Ipv4Header &header, Ptr<const Packet> packet,
+                                  uint32_t interface)
+{
+  Log ("tx", header, packet);
+}
+
+void
+DistributedFlowLog::LocalDeliver (const Ipv4Header &header, Ptr<const Packet> packet,
+                                  uint32_t interface)
+{
+  Log ("rx", header, packet);
+}
+
+void
+DistributedFlowLog::Log (const char *type, const Ipv4Header &header, Ptr<const Packet> packet)
+{
+  // the same packets, and the same size, as Ipv4FlowProbe counts
+  FlowId flowId;
+  FlowPacketId packetId;
+  if (!m_classifier->Classify (header, packet, &flowId, &packetId))
+    {
+      return;
+    }
+
+  if (flowId > m_nFlows)
+    {
+      Ipv4FlowClassifier::FiveTuple t = m_classifier->FindFlow (flowId);
+      m_os << "flow " << flowId << " " << t.sourceAddress << " " << t.destinationAddress << " "
+           << uint32_t (t.protocol) << " " << t.sourcePort << " " << t.destinationPort << "\n";
+      m_nFlows = flowId;
+    }
+
+  m_os << type << " " << flowId << " " << header.GetIdentification () << " "
+       << Simulator::Now ().GetNanoSeconds () << " "
+       << packet->GetSize () + header.GetSerializedSize () << "\n";
+}
+
+} // namespace ns3
@@ -0,0 +1,51 @@
+#ifndef DISTRIBUTEDFLOWLOG_H
+#define DISTRIBUTEDFLOWLOG_H
+
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include <fstream>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * Per-packet flow record for simulations split over MPI ranks.
+ *
+ * FlowMonitor matches a delivered packet against its own table of
+ * transmitted packets, so a flow whose two ends are on different ranks
+ * gets no rx statistics.  Instead, each rank logs the IPv4 transmissions
+ * and local deliveries of its own nodes:
+ *   flow <id> <src> <dst> <protocol> <srcPort> <dstPort>
+ *   tx <id> <ipId> <time ns> <bytes>
+ *   rx <id> <ipId> <time ns> <bytes>
+ *   end <time ns>
+ * Flow ids are local to the log.  Across ranks, a packet is identified by
+ * its five-tuple plus the IPv4 identification field.  Task-A-Code/Wired/
+ * mergeFlowLogs.py joins the rank logs into the .flowstats file a single
+ * process FlowMonitor would have written.
+ */
+class DistributedFlowLog {
+public:
+  DistributedFlowLog (std::string fileName);
+  ~DistributedFlowLog ();
+
+  void Install (NodeContainer nodes);
+
+  /** Write the end time and close the log; call before Simulator::Destroy. */
+  void Close ();
+
+private:
+  void SendOutgoing (const Ipv4Header &header, Ptr<const Packet> packet, uint32_t interface);
+  void LocalDeliver (const Ipv4Header &header, Ptr<const Packet> packet, uint32_t interface);
+  void Log (const char *type, const Ipv4Header &header, Ptr<const Packet> packet);
+
+  Ptr<Ipv4FlowClassifier> m_classifier;
+  uint32_t m_nFlows;
+  std::ofstream m_os;
+};
+
+}
+
+#endif
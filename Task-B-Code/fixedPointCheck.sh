@@ -0,0 +1,50 @@
+#!/bin/bash
+
+# TcpLrNewReno's FixedPoint window update has to leave the Task B results
+# bit-for-bit unchanged. Checks the update itself with tcp-lr-newreno-check,
+# then runs the TcpLrNewReno part of the wpanB.sh grid with --fixedPoint=0
+# and 1, each in its own directory, and compares every .cwnd and .flowstats
+# file. Run from the ns-3 directory.
+
+grid="scratch/mywpanB --sweep=n_nodes=1,4 --warmStart=congestionAlgo=TcpLrNewReno;error_rate=0,0.02,0.04,0.06,0.08,0.10 --duration=100 --cwndTrace=1"
+
+./waf --run "scratch/tcp-lr-newreno-check" || exit 1
+
+for fixedPoint in 0 1; do
+    rm -rf fixedPoint$fixedPoint && mkdir fixedPoint$fixedPoint
+    ./waf --run "$grid --fixedPoint=$fixedPoint" --cwd=fixedPoint$fixedPoint > /dev/null || exit 1
+done
+
+# the writer thread interleaves the flows of a .cwnd file differently from
+# run to run, so those are compared flow by flow
+sameCwnd() {
+    python3 - "$1" "$2" <<'PY'
+import sys
+def flows(path):
+    data = open(path, 'rb').read()
+    size = int.from_bytes(data[12:16], 'little')
+    records = [data[i:i+size] for i in range(16, len(data), size)]
+    # stable: each flow's records stay in time order
+    records.sort(key=lambda r: r[8:12])
+    return data[:16] + b''.join(records)
+sys.exit(flows(sys.argv[1]) != flows(sys.argv[2]))
+PY
+}
+
+status=0
+files=0
+for file in fixedPoint0/*.cwnd fixedPoint0/*.flowstats; do
+    name=$(basename $file)
+    files=$((files+1))
+    if [ ! -f fixedPoint1/$name ]; then same=1
+    elif [[ $name == *.cwnd ]]; then sameCwnd $file fixedPoint1/$name; same=$?
+    else cmp -s $file fixedPoint1/$name; same=$?
+    fi
+    if [ $same -ne 0 ]; then
+        echo "$name differs"
+        status=1
+    fi
+done
+
+if [ $status -eq 0 ]; then echo "$files files identical with --fixedPoint=0 and 1"; fi
+exit $status
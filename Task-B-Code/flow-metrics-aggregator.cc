@@ -0,0 +1,110 @@
+#include "flow-metrics-aggregator.h"
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowMetricsAggregator");
+
+FlowMetricsAggregator::FlowMetricsAggregator (Ptr<FlowMonitor> monitor)
+  : m_monitor (monitor),
+    m_skipIdleFlows (false)
+{
+  NS_LOG_FUNCTION (this << monitor);
+}
+
+void
+FlowMetricsAggregator::SetSkipIdleFlows (bool skip)
+{
+  m_skipIdleFlows = skip;
+}
+
+FlowMetrics
+FlowMetricsAggregator::Summarize () const
+{
+  NS_LOG_FUNCTION (this);
+
+  m_monitor->CheckForLostPackets ();
+  const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+
+  FlowMetrics metrics;
+  double throughput = 0, delaySum = 0;
+  uint32_t forwardFlows = (stats.size () + 1) / 2, i = 0;
+  for (FlowMonitor::FlowStatsContainerCI it = stats.begin (); i < forwardFlows; it++, i++)
+    {
+      const FlowMonitor::FlowStats &flow = it->second;
+      double duration = (flow.timeLastRxPacket - flow.timeFirstRxPacket).GetSeconds ();
+      if (m_skipIdleFlows && (flow.rxPackets == 0 || duration == 0))
+        {
+          continue;
+        }
+      if (duration != 0)
+        {
+          throughput += flow.rxBytes * 8 / duration;
+        }
+      metrics.txPackets += flow.txPackets;
+      metrics.rxPackets += flow.rxPackets;
+      delaySum += flow.delaySum.GetNanoSeconds ();
+    }
+
+  metrics.throughput = throughput / 1024;
+  metrics.delay = metrics.rxPackets ? delaySum / metrics.rxPackets / 1000 : INFINITY;
+  if (metrics.txPackets)
+    {
+      metrics.deliveryRatio = 100.0 * metrics.rxPackets / metrics.txPackets;
+      metrics.dropRatio = 100.0 * (metrics.txPackets - metrics.rxPackets) / metrics.txPackets;
+    }
+
+  NS_LOG_INFO ("Throughput " << metrics.throughput << " kbps, delay " << metrics.delay
+               << " us over " << forwardFlows << " flows");
+  return metrics;
+}
+
+void
+FlowMetricsAggregator::AppendCsvRow (std::string fileName,
+                                     std::vector<std::pair<std::string, std::string> > keys,
+                                     int throughputDecimals) const
+{
+  NS_LOG_FUNCTION (this << fileName);
+
+  FlowMetrics metrics = Summarize ();
+
+  std::ostringstream header, row;
+  for (std::pair<std::string, std::string> key : keys)
+    {
+      header << key.first << ",";
+      row << key.second << ",";
+    }
+  header << "Throughput,End to End Delay,Delivery Ratio,Drop Ratio\n";
+  row << std::fixed << std::setprecision (throughputDecimals) << metrics.throughput << ","
+      << std::setprecision (0) << metrics.delay << ","
+      << std::setprecision (2) << metrics.deliveryRatio << "," << metrics.dropRatio << "\n";
+
+  int fd = open (fileName.c_str (), O_WRONLY | O_APPEND | O_CREAT, 0644);
+  if (fd < 0)
+    {
+      NS_FATAL_ERROR ("Can't open file " << fileName);
+    }
+  flock (fd, LOCK_EX);
+  struct stat st;
+  std::string out = row.str ();
+  if (fstat (fd, &st) == 0 && st.st_size == 0)
+    {
+      out = header.str () + out;
+    }
+  if (write (fd, out.data (), out.size ()) != (ssize_t) out.size ())
+    {
+      NS_FATAL_ERROR ("Can't write to " << fileName);
+    }
+  flock (fd, LOCK_UN);
+  close (fd);
+}
+
+} // namespace ns3
@@ -0,0 +1,60 @@
+#ifndef FLOWMETRICSAGGREGATOR_H
+#define FLOWMETRICSAGGREGATOR_H
+
+#include "ns3/flow-monitor.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Run level metrics, in the units of the results.csv files.
+ */
+struct FlowMetrics {
+  double throughput {0};      //!< sum of per-flow throughput, kbit/s (1024 bit)
+  double delay {0};           //!< mean end to end delay, us
+  double deliveryRatio {0};   //!< received / sent packets, %
+  double dropRatio {0};       //!< lost / sent packets, %
+  uint64_t txPackets {0};
+  uint64_t rxPackets {0};
+};
+
+/**
+ * Computes the metrics of the processFlow*.py scripts inside the
+ * simulator, straight from the FlowMonitor's per-flow counters, so a
+ * sweep can write results.csv rows without the XML and pandas stage.
+ *
+ * Like the scripts, only the first half of the flows (by FlowId) are
+ * counted: the second half are the reverse TCP ACK flows.
+ */
+class FlowMetricsAggregator {
+public:
+  FlowMetricsAggregator (Ptr<FlowMonitor> monitor);
+
+  /**
+   * Skip flows that received nothing or received in a single instant,
+   * as processFlowB.py does.  Off by default, as in processFlowA_*.py.
+   */
+  void SetSkipIdleFlows (bool skip);
+
+  FlowMetrics Summarize () const;
+
+  /**
+   * Append one row (keys, then the metrics) to a CSV file, writing the
+   * header first if the file is empty.  The file is locked while writing
+   * so parallel sweep workers can share it.  Throughput is rounded to
+   * throughputDecimals, as the scenario's processFlow script rounds it.
+   */
+  void AppendCsvRow (std::string fileName,
+                     std::vector<std::pair<std::string, std::string> > keys,
+                     int throughputDecimals = 2) const;
+
+private:
+  Ptr<FlowMonitor> m_monitor;
+  bool m_skipIdleFlows;
+};
+
+}
+
+#endif
@@ -0,0 +1,195 @@
+#include "flow-placement.h"
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowPlacement");
+
+FlowPlacement::Random::Random (uint64_t seed)
+  : m_state (seed)
+{
+}
+
+uint64_t
+FlowPlacement::Random::Next ()
+{
+  uint64_t z = (m_state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+uint32_t
+FlowPlacement::Random::Below (uint32_t n)
+{
+  // the high bits of a 64x32 bit product; the bias is below 2^-32
+  return (uint32_t) (((unsigned __int128) Next () * n) >> 64);
+}
+
+double
+FlowPlacement::Random::Uniform ()
+{
+  return (Next () >> 11) * (1.0 / (1ULL << 53));
+}
+
+FlowPlacement::AliasTable::AliasTable (const std::vector<uint32_t> &weights)
+  : m_probability (weights.size ()),
+    m_alias (weights.size ())
+{
+  double total = 0;
+  for (uint32_t weight : weights)
+    {
+      total += weight;
+    }
+
+  std::vector<uint32_t> small, large;
+  std::vector<double> scaled (weights.size ());
+  for (uint32_t i = 0; i < weights.size (); i++)
+    {
+      scaled[i] = weights[i] * weights.size () / total;
+      (scaled[i] < 1 ? small : large).push_back (i);
+    }
+  while (!small.empty () && !large.empty ())
+    {
+      uint32_t s = small.back (), l = large.back ();
+      small.pop_back ();
+      m_probability[s] = scaled[s];
+      m_alias[s] = l;
+      scaled[l] -= 1 - scaled[s];
+      if (scaled[l] < 1)
+        {
+          large.pop_back ();
+          small.push_back (l);
+        }
+    }
+  // what is left is 1 up to rounding
+  for (uint32_t i : small)
+    {
+      m_probability[i] = 1;
+    }
+  for (uint32_t i : large)
+    {
+      m_probability[i] = 1;
+    }
+}
+
+uint32_t
+FlowPlacement::AliasTable::Draw (Random &random) const
+{
+  uint32_t i = random.Below (m_probability.size ());
+  return random.Uniform () < m_probability[i] ? i : m_alias[i];
+}
+
+FlowPlacement::FlowPlacement (uint64_t seed)
+  : m_seed (seed),
+    m_matrix (UNIFORM),
+    m_hotspot (0),
+    m_hotspotFraction (0.5)
+{
+  NS_LOG_FUNCTION (this << seed);
+}
+
+void
+FlowPlacement::SetTrafficMatrix (std::string spec)
+{
+  NS_LOG_FUNCTION (this << spec);
+  std::istringstream is (spec);
+  std::string name, hotspot, fraction;
+  std::getline (is, name, ':');
+  std::getline (is, hotspot, ':');
+  std::getline (is, fraction, ':');
+
+  if (name == "uniform" && hotspot.empty ())
+    {
+      m_matrix = UNIFORM;
+    }
+  else if (name == "gravity" && hotspot.empty ())
+    {
+      m_matrix = GRAVITY;
+    }
+  else if (name == "hotspot")
+    {
+      m_matrix = HOTSPOT;
+      m_hotspot = hotspot.empty () ? 0 : std::stoul (hotspot);
+      m_hotspotFraction = fraction.empty () ? 0.5 : std::stod (fraction);
+      if (m_hotspotFraction < 0 || m_hotspotFraction > 1)
+        {
+          NS_FATAL_ERROR ("Hotspot fraction " << m_hotspotFraction << " is not in [0, 1]");
+        }
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unknown traffic matrix \"" << spec << "\"");
+    }
+}
+
+std::vector<FlowPair>
+FlowPlacement::Place (const std::vector<uint32_t> &hosts, uint32_t nFlows) const
+{
+  NS_LOG_FUNCTION (this << hosts.size () << nFlows);
+  uint32_t nGroups = hosts.size ();
+  if (nGroups < 2)
+    {
+      NS_FATAL_ERROR ("Flows need at least two groups, not " << nGroups);
+    }
+  for (uint32_t group = 0; group < nGroups; group++)
+    {
+      if (hosts[group] == 0)
+        {
+          NS_FATAL_ERROR ("Group " << group << " has no hosts");
+        }
+    }
+  if (m_matrix == HOTSPOT && m_hotspot >= nGroups)
+    {
+      NS_FATAL_ERROR ("Hotspot group " << m_hotspot << " of " << nGroups);
+    }
+
+  Random random (m_seed);
+  AliasTable bySize (hosts);
+  std::vector<uint32_t> nextSource (nGroups, 0);
+  std::vector<FlowPair> flows (nFlows);
+
+  for (uint32_t i = 0; i < nFlows; i++)
+    {
+      FlowPair &flow = flows[i];
+      if (m_matrix == GRAVITY)
+        {
+          flow.srcGroup = bySize.Draw (random);
+        }
+      else
+        {
+          // equal shares in group order, the last group taking the remainder
+          flow.srcGroup = std::min (i / (nFlows / nGroups ? nFlows / nGroups : 1), nGroups - 1);
+        }
+      flow.srcHost = nextSource[flow.srcGroup];
+      nextSource[flow.srcGroup] = (flow.srcHost + 1) % hosts[flow.srcGroup];
+
+      if (m_matrix == GRAVITY)
+        {
+          // at least half the draws miss the source unless one group has most of the hosts
+          do
+            {
+              flow.dstGroup = bySize.Draw (random);
+            }
+          while (flow.dstGroup == flow.srcGroup);
+        }
+      else if (m_matrix == HOTSPOT && flow.srcGroup != m_hotspot && random.Uniform () < m_hotspotFraction)
+        {
+          flow.dstGroup = m_hotspot;
+        }
+      else
+        {
+          flow.dstGroup = random.Below (nGroups - 1);
+          if (flow.dstGroup >= flow.srcGroup)
+            {
+              flow.dstGroup++;
+            }
+        }
+      flow.dstHost = random.Below (hosts[flow.dstGroup]);
+    }
+  return flows;
+}
+
+} // namespace ns3
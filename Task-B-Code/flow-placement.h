@@ -0,0 +1,82 @@
+#ifndef FLOWPLACEMENT_H
+#define FLOWPLACEMENT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * One flow: host srcHost of group srcGroup sends to host dstHost of
+ * group dstGroup.
+ */
+struct FlowPair {
+  uint32_t srcGroup;
+  uint32_t srcHost;
+  uint32_t dstGroup;
+  uint32_t dstHost;
+};
+
+/**
+ * Places flows between groups of hosts (e.g. the hosts behind each
+ * router) after a traffic matrix.  Flows always leave their own group.
+ *
+ *  - "uniform": each group sources an equal share of the flows, and each
+ *    flow goes to one of the other groups at random.
+ *  - "hotspot[:group[:fraction]]": as uniform, but a fraction (default
+ *    0.5) of the flows from other groups go to the hotspot group
+ *    (default 0).
+ *  - "gravity": the source and destination groups are drawn in
+ *    proportion to their number of hosts.
+ *
+ * Source hosts are taken in turn within each group, and destination hosts
+ * are drawn at random.  The placement depends only on the seed, the
+ * matrix and the group sizes, not on the simulator's random streams, so
+ * runs of different algorithms with the same seed get the same flows.
+ * Placing n flows over g groups takes O(n + g).
+ */
+class FlowPlacement {
+public:
+  FlowPlacement (uint64_t seed);
+
+  void SetTrafficMatrix (std::string spec);
+
+  /** \param hosts hosts[g] is the number of hosts in group g */
+  std::vector<FlowPair> Place (const std::vector<uint32_t> &hosts, uint32_t nFlows) const;
+
+private:
+  enum Matrix { UNIFORM, HOTSPOT, GRAVITY };
+
+  /** splitmix64, the same sequence on every platform */
+  class Random {
+  public:
+    Random (uint64_t seed);
+    uint64_t Next ();
+    /** uniform in [0, n) */
+    uint32_t Below (uint32_t n);
+    /** uniform in [0, 1) */
+    double Uniform ();
+  private:
+    uint64_t m_state;
+  };
+
+  /** Walker's alias table, to draw groups by weight in O(1). */
+  class AliasTable {
+  public:
+    AliasTable (const std::vector<uint32_t> &weights);
+    uint32_t Draw (Random &random) const;
+  private:
+    std::vector<double> m_probability;
+    std::vector<uint32_t> m_alias;
+  };
+
+  uint64_t m_seed;
+  Matrix m_matrix;
+  uint32_t m_hotspot;
+  double m_hotspotFraction;
+};
+
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef FLOWSTATSFILEREADER_H
+#define FLOWSTATSFILEREADER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+/**
+ * Layout of the .flowstats files written by FlowStatsFile::Serialize.
+ *
+ * A 32 byte header is followed by one column per field, each holding
+ * nFlows little-endian 64 bit integers in FlowId order.  Times are in
+ * nanoseconds.  Every column is 8 byte aligned, so a column can be used
+ * straight out of the mapped file (numpy.memmap reads it the same way).
+ *
+ * This header does not depend on ns-3 so that post-processing tools can
+ * include it on their own.
+ */
+struct FlowStatsFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t nColumns;
+  uint64_t nFlows;
+  uint64_t reserved;
+};
+
+static const char FLOW_STATS_MAGIC[8] = {'N', 'S', '3', 'F', 'L', 'O', 'W', 'S'};
+static const uint32_t FLOW_STATS_VERSION = 1;
+
+enum FlowStatsColumn {
+  FLOW_ID,
+  TIME_FIRST_TX_PACKET,
+  TIME_FIRST_RX_PACKET,
+  TIME_LAST_TX_PACKET,
+  TIME_LAST_RX_PACKET,
+  DELAY_SUM,
+  JITTER_SUM,
+  LAST_DELAY,
+  TX_BYTES,
+  RX_BYTES,
+  TX_PACKETS,
+  RX_PACKETS,
+  LOST_PACKETS,
+  TIMES_FORWARDED,
+  FLOW_STATS_N_COLUMNS
+};
+
+/**
+ * Maps a .flowstats file read-only and hands out pointers to its columns
+ * without copying them.
+ */
+class FlowStatsFileReader {
+public:
+  FlowStatsFileReader () : m_data (0), m_size (0), m_nFlows (0) {}
+  ~FlowStatsFileReader () { Close (); }
+
+  /**
+   * \return false if the file cannot be mapped or is not a complete
+   * .flowstats file of this version
+   */
+  bool Open (std::string path)
+  {
+    Close ();
+    int fd = open (path.c_str (), O_RDONLY);
+    if (fd < 0)
+      {
+        return false;
+      }
+    struct stat st;
+    if (fstat (fd, &st) != 0 || st.st_size < (off_t) sizeof (FlowStatsFileHeader))
+      {
+        close (fd);
+        return false;
+      }
+    void *data = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);
+    if (data == MAP_FAILED)
+      {
+        return false;
+      }
+    m_data = static_cast<const char*> (data);
+    m_size = st.st_size;
+
+    const FlowStatsFileHeader *header = reinterpret_cast<const FlowStatsFileHeader*> (m_data);
+    if (std::memcmp (header->magic, FLOW_STATS_MAGIC, sizeof (FLOW_STATS_MAGIC)) != 0
+        || header->version != FLOW_STATS_VERSION
+        || header->nColumns != FLOW_STATS_N_COLUMNS
+        || m_size < sizeof (FlowStatsFileHeader) + header->nColumns * header->nFlows * sizeof (int64_t))
+      {
+        Close ();
+        return false;
+      }
+    m_nFlows = header->nFlows;
+    return true;
+  }
+
+  void Close ()
+  {
+    if (m_data)
+      {
+        munmap (const_cast<char*> (m_data), m_size);
+      }
+    m_data = 0;
+    m_size = 0;
+    m_nFlows = 0;
+  }
+
+  uint64_t GetNFlows () const { return m_nFlows; }
+
+  const int64_t *GetColumn (FlowStatsColumn column) const
+  {
+    return reinterpret_cast<const int64_t*> (m_data + sizeof (FlowStatsFileHeader))
+           + column * m_nFlows;
+  }
+
+private:
+  FlowStatsFileReader (const FlowStatsFileReader&);
+  FlowStatsFileReader &operator= (const FlowStatsFileReader&);
+
+  const char *m_data;
+  size_t m_size;
+  uint64_t m_nFlows;
+};
+
+}
+
+#endif
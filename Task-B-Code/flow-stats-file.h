@@ -0,0 +1,24 @@
+#ifndef FLOWSTATSFILE_H
+#define FLOWSTATSFILE_H
+
+#include "ns3/flow-monitor.h"
+#include "flow-stats-file-reader.h"
+#include <string>
+
+namespace ns3 {
+
+/**
+ * Compact replacement for FlowMonitor::SerializeToXmlFile.
+ *
+ * Only the per-flow counters are kept (no histograms or probe stats),
+ * written column by column in the layout described in
+ * flow-stats-file-reader.h.
+ */
+class FlowStatsFile {
+public:
+  static void Serialize (Ptr<FlowMonitor> monitor, std::string fileName);
+};
+
+}
+
+#endif
@@ -0,0 +1,188 @@
+#include "ns3/core-module.h"
+#include "ns3/ladder-scheduler.h"
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+using namespace std;
+using namespace ns3;
+
+/*
+    Checks LadderScheduler against a std::set of the same event keys. After
+    every Insert, RemoveNext and Remove, both must agree on IsEmpty and
+    PeekNext, and RemoveNext must return the set's first event. Each round
+    runs three kinds of sequences:
+
+        random  delays from 0 to 1e12 ns, so events land in Top, the rungs
+                and Bottom, with random removes by timestamp
+        burst   more than Threshold events at one timestamp, which can't be
+                spread by splitting, removed from and added to while draining
+        deep    a tight cluster of events under one far event, so each
+                bucket split leaves the cluster in a single bucket again,
+                down to MaxRungs; new events and removes go into the rungs
+                in use, including ones with no events left
+
+    Exits non-zero and prints the first differing operation on a mismatch.
+    Task-A-Code/schedulerBench.sh runs it before benchmarking.
+*/
+
+uint64_t n_ops=2000000, seed=1, ops=0;
+
+Ptr<LadderScheduler> ladder;
+set<Scheduler::EventKey> reference;
+uint32_t uid=0;
+uint64_t now=0;
+mt19937_64 rng;
+
+uint64_t uniform(uint64_t lo, uint64_t hi) {
+    return lo + rng() % (hi-lo+1);
+}
+
+void printEvent(const char* name, const Scheduler::EventKey& key) {
+    std::cout << ", " << name << " ts " << key.m_ts << " uid " << key.m_uid;
+}
+
+// both queues agree on the next event
+bool check(const char* kind, const char* op) {
+    ops++;
+    if( ladder->IsEmpty()==reference.empty() && (reference.empty()
+        || ladder->PeekNext().key.m_uid==reference.begin()->m_uid) ) return true;
+
+    std::cout << "Mismatch (" << kind << ") after " << op << " " << ops << ": "
+              << reference.size() << " events pending";
+    if( !ladder->IsEmpty() ) printEvent("ladder next", ladder->PeekNext().key);
+    if( !reference.empty() ) printEvent("reference next", *reference.begin());
+    std::cout << "\n";
+    return false;
+}
+
+bool insert(uint64_t ts, const char* kind) {
+    Scheduler::Event ev;
+    ev.impl = 0;
+    ev.key.m_ts = ts;
+    ev.key.m_uid = uid++;
+    ev.key.m_context = 0;
+    ladder->Insert(ev);
+    reference.insert(ev.key);
+    return check(kind, "Insert");
+}
+
+bool removeNext(const char* kind) {
+    Scheduler::Event ev = ladder->RemoveNext();
+    Scheduler::EventKey expected = *reference.begin();
+    reference.erase(reference.begin());
+    now = expected.m_ts;
+    if( ev.key.m_uid!=expected.m_uid ) {
+        std::cout << "Mismatch (" << kind << ") at RemoveNext " << ops+1;
+        printEvent("ladder", ev.key);
+        printEvent("reference", expected);
+        std::cout << "\n";
+        return false;
+    }
+    return check(kind, "RemoveNext");
+}
+
+// the first pending event at or after a random time, as a cancel would pick
+bool removeEvent(const char* kind) {
+    uint64_t ts = uniform(reference.begin()->m_ts, reference.rbegin()->m_ts);
+    Scheduler::EventKey key = {ts, 0, 0};
+    set<Scheduler::EventKey>::iterator it = reference.lower_bound(key);
+    if( it==reference.end() ) it = reference.begin();
+    Scheduler::Event ev;
+    ev.impl = 0;
+    ev.key = *it;
+    reference.erase(it);
+    ladder->Remove(ev);
+    return check(kind, "Remove");
+}
+
+uint64_t randomDelay() {
+    switch( rng() % 5 ) {
+        case 0: return 0;
+        case 1: return uniform(0, 10);
+        case 2: return uniform(0, 100000);
+        case 3: return uniform(0, 1000000000);
+        default: return uniform(0, 1000000000000);
+    }
+}
+
+bool runRandom() {
+    for( uint i=0; i<2000; i++ ) {
+        uint r = rng() % 10;
+        if( r<5 || reference.empty() ) {
+            if( !insert(now+randomDelay(), "random") ) return false;
+        }
+        else if( r<9 ) {
+            if( !removeNext("random") ) return false;
+        }
+        else if( !removeEvent("random") ) return false;
+    }
+    return true;
+}
+
+bool runBurst() {
+    uint64_t ts = now + uniform(0, 1000);
+    uint n = uniform(LadderScheduler::Threshold+1, 8*LadderScheduler::Threshold);
+    for( uint i=0; i<n; i++ ) {
+        if( !insert(ts, "burst") ) return false;
+    }
+    while( !reference.empty() && reference.begin()->m_ts<=ts ) {
+        uint r = rng() % 10;
+        if( r<6 ) {
+            if( !removeNext("burst") ) return false;
+        }
+        else if( r<8 ) {
+            if( !removeEvent("burst") ) return false;
+        }
+        else if( !insert(ts + uniform(0, 1), "burst") ) return false;
+    }
+    return true;
+}
+
+bool runDeep() {
+    // drain first, then hold Bottom with one event so the cluster and the
+    // far event wait in Top and build the first rung together
+    while( !reference.empty() ) {
+        if( !removeNext("deep") ) return false;
+    }
+    if( !insert(now, "deep") ) return false;
+    uint64_t far = uniform(1ull << 44, 1ull << 50);
+    if( !insert(now+far, "deep") ) return false;
+    uint64_t start = now + uniform(1, 1000), span = uniform(1, 64);
+    uint n = uniform(LadderScheduler::Threshold+1, 3*LadderScheduler::Threshold);
+    for( uint i=0; i<n; i++ ) {
+        if( !insert(start + uniform(0, span-1), "deep") ) return false;
+    }
+    while( !reference.empty() ) {
+        uint r = rng() % 10;
+        if( r<6 ) {
+            if( !removeNext("deep") ) return false;
+        }
+        else if( r<7 ) {
+            if( !removeEvent("deep") ) return false;
+        }
+        else if( r<9 ) {
+            // just ahead of now, into Bottom or a fine rung
+            if( !insert(now + uniform(0, span), "deep") ) return false;
+        }
+        else if( !insert(now + randomDelay(), "deep") ) return false;
+    }
+    return true;
+}
+
+int main (int argc, char** argv) {
+    CommandLine cmd (__FILE__);
+    cmd.AddValue ("n_ops", "Operations Checked", n_ops);
+    cmd.AddValue ("seed", "Random Seed", seed);
+    cmd.Parse (argc, argv);
+
+    rng.seed(seed);
+    ladder = CreateObject<LadderScheduler> ();
+
+    while( ops<n_ops ) {
+        if( !runRandom() || !runBurst() || !runDeep() ) return 1;
+    }
+
+    std::cout << ops << " Operations: LadderScheduler Matches The Reference Queue\n";
+    return 0;
+}
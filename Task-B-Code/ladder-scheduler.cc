@@ -0,0 +1,247 @@
+#include "ladder-scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+const uint32_t LadderScheduler::Threshold;
+const uint32_t LadderScheduler::MaxRungs;
+
+// Bottom's order: latest first
+static bool
+Later (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return b.key < a.key;
+}
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topStart (0),
+    m_topMin (0),
+    m_topMax (0),
+    m_rungs (MaxRungs),
+    m_nRungs (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+LadderScheduler::FindRung (uint64_t ts) const
+{
+  for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+      if (ts >= m_rungs[i].GetCurrentStart ())
+        {
+          return i;
+        }
+    }
+  return m_nRungs;
+}
+
+LadderScheduler::Rung &
+LadderScheduler::PushRung (uint64_t start, uint64_t width, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << start << width << n);
+  // m_rungs never grows, so references to the rungs above stay valid
+  Rung &rung = m_rungs[m_nRungs++];
+  rung.start = start;
+  rung.width = width;
+  rung.current = 0;
+  rung.count = 0;
+  if (rung.buckets.size () < n)
+    {
+      rung.buckets.resize (n);
+    }
+  return rung;
+}
+
+void
+LadderScheduler::InsertIntoRung (Rung &rung, const Event &ev)
+{
+  uint64_t bucket = (ev.key.m_ts - rung.start) / rung.width;
+  NS_ASSERT (bucket >= rung.current && bucket < rung.buckets.size ());
+  rung.buckets[bucket].push_back (ev);
+  rung.count++;
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      if (m_top.empty ())
+        {
+          m_topMin = m_topMax = ts;
+        }
+      m_topMin = std::min (m_topMin, ts);
+      m_topMax = std::max (m_topMax, ts);
+      m_top.push_back (ev);
+      Refill ();
+      return;
+    }
+
+  uint32_t rung = FindRung (ts);
+  if (rung < m_nRungs)
+    {
+      InsertIntoRung (m_rungs[rung], ev);
+    }
+  else
+    {
+      m_bottom.insert (std::upper_bound (m_bottom.begin (), m_bottom.end (), ev, Later), ev);
+    }
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  return m_bottom.empty ();
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  return m_bottom.back ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  Refill ();
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  std::vector<Event> *events = &m_bottom;
+  if (ts >= m_topStart)
+    {
+      events = &m_top;
+    }
+  else
+    {
+      uint32_t i = FindRung (ts);
+      if (i < m_nRungs)
+        {
+          Rung &rung = m_rungs[i];
+          events = &rung.buckets[(ts - rung.start) / rung.width];
+          rung.count--;
+        }
+    }
+
+  if (events == &m_bottom)
+    {
+      std::vector<Event>::iterator it = std::lower_bound (m_bottom.begin (), m_bottom.end (), ev, Later);
+      NS_ASSERT (it != m_bottom.end () && it->key.m_uid == ev.key.m_uid);
+      m_bottom.erase (it);
+    }
+  else
+    {
+      // Top and the buckets are unsorted
+      std::vector<Event>::iterator it = events->begin ();
+      while (it != events->end () && it->key.m_uid != ev.key.m_uid)
+        {
+          it++;
+        }
+      NS_ASSERT (it != events->end ());
+      *it = events->back ();
+      events->pop_back ();
+    }
+  Refill ();
+}
+
+void
+LadderScheduler::Refill (void)
+{
+  while (m_bottom.empty ())
+    {
+      // a rung can only be dropped once Bottom, which it bounds, is empty
+      while (m_nRungs > 0 && m_rungs[m_nRungs - 1].count == 0)
+        {
+          m_nRungs--;
+        }
+
+      if (m_nRungs == 0)
+        {
+          if (m_top.empty ())
+            {
+              m_topStart = 0;
+              return;
+            }
+          // one bucket per event over Top's span, which becomes the first rung
+          uint32_t n = m_top.size ();
+          uint64_t width = (m_topMax - m_topMin) / n + 1;
+          Rung &rung = PushRung (m_topMin, width, n);
+          m_topStart = m_topMin + n * width;
+          for (const Event &ev : m_top)
+            {
+              InsertIntoRung (rung, ev);
+            }
+          m_top.clear ();
+          continue;
+        }
+
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.buckets[rung.current].empty ())
+        {
+          rung.current++;
+        }
+      std::vector<Event> &bucket = rung.buckets[rung.current];
+      uint64_t bucketStart = rung.GetCurrentStart ();
+      rung.current++;
+      rung.count -= bucket.size ();
+
+      if (bucket.size () > Threshold && rung.width > 1 && m_nRungs < MaxRungs)
+        {
+          // too many to sort: spread them over a finer rung
+          uint32_t n = bucket.size ();
+          uint64_t width = (rung.width + n - 1) / n;
+          n = (rung.width + width - 1) / width;
+          Rung &child = PushRung (bucketStart, width, n);
+          for (const Event &ev : bucket)
+            {
+              InsertIntoRung (child, ev);
+            }
+          bucket.clear ();
+        }
+      else
+        {
+          // Bottom is empty, so the bucket keeps Bottom's spare capacity
+          m_bottom.swap (bucket);
+          std::sort (m_bottom.begin (), m_bottom.end (), Later);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,82 @@
+#ifndef LADDERSCHEDULER_H
+#define LADDERSCHEDULER_H
+
+#include "ns3/scheduler.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Ladder queue event scheduler (Tang, Goh and Thng, "Ladder Queue: An
+ * O(1) Priority Queue Structure for Large-Scale Discrete Event
+ * Simulation", 2005).
+ *
+ * Events go into one of three tiers, by timestamp:
+ *  - Top: far future events, unsorted.
+ *  - Ladder: rungs of buckets.  A rung's buckets are unsorted, and an
+ *    overfull bucket is split into a finer rung below when it is reached.
+ *  - Bottom: the events of the bucket being consumed, sorted.
+ * Insert is O(1) into Top or a rung, and each event is sorted once, in a
+ * bucket of at most about Threshold events.  PeekNext is always the last
+ * element of Bottom, which is refilled after every removal.
+ *
+ * Unlike the paper, Bottom is never converted back into a rung.  It only
+ * takes events due before the current bucket ends, which in ns-3 are
+ * mostly ScheduleNow and short delays, and it stays small.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  LadderScheduler ();
+  virtual ~LadderScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+  /** A bucket with more events than this is split when it is reached. */
+  static const uint32_t Threshold = 50;
+  /** The most rungs in use; a bucket of the last one is sorted whatever its size. */
+  static const uint32_t MaxRungs = 8;
+
+private:
+  struct Rung
+  {
+    uint64_t start;
+    uint64_t width;
+    uint32_t current;   //!< first bucket not yet moved down
+    uint32_t count;     //!< events left in the rung
+    std::vector<std::vector<Event> > buckets;
+
+    uint64_t GetCurrentStart (void) const
+    {
+      return start + current * width;
+    }
+  };
+
+  /** The rung an event of time ts belongs in, or m_nRungs for Bottom. */
+  uint32_t FindRung (uint64_t ts) const;
+  /** Set up rung m_nRungs over [start, start + n * width) and add it. */
+  Rung &PushRung (uint64_t start, uint64_t width, uint32_t n);
+  void InsertIntoRung (Rung &rung, const Event &ev);
+  /** Refill Bottom from the ladder, or the ladder from Top, if Bottom is empty. */
+  void Refill (void);
+
+  std::vector<Event> m_top;
+  uint64_t m_topStart;   //!< Top holds the events at or after this time
+  uint64_t m_topMin;
+  uint64_t m_topMax;
+
+  std::vector<Rung> m_rungs;   //!< coarsest first; only m_nRungs are in use
+  uint32_t m_nRungs;
+
+  std::vector<Event> m_bottom;   //!< latest first, the next event last
+};
+
+}
+
+#endif
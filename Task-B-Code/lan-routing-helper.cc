@@ -0,0 +1,208 @@
+#include "lan-routing-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LanRoutingHelper");
+
+static const uint32_t NO_LINK = 0xffffffff;
+
+std::map<std::string, std::vector<uint32_t> > LanRoutingHelper::s_nextLinks;
+
+LanRoutingHelper::LanRoutingHelper ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LanRoutingHelper::SetCacheDirectory (std::string directory)
+{
+  m_cacheDirectory = directory;
+}
+
+void
+LanRoutingHelper::AddRouterLink (uint32_t a, uint32_t b, NetDeviceContainer devices,
+                                 Ipv4InterfaceContainer interfaces)
+{
+  m_links.push_back ({a, b, devices, interfaces});
+}
+
+void
+LanRoutingHelper::AddLan (uint32_t router, NetDeviceContainer devices,
+                          Ipv4InterfaceContainer interfaces, Ipv4Mask mask)
+{
+  m_lans.push_back ({router, devices, interfaces, mask});
+}
+
+std::vector<uint32_t>
+LanRoutingHelper::ComputeNextLinks (uint32_t nRouters) const
+{
+  NS_LOG_FUNCTION (this << nRouters);
+
+  std::vector<std::vector<uint32_t> > adjacent (nRouters);
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      adjacent[m_links[l].a].push_back (l);
+      adjacent[m_links[l].b].push_back (l);
+    }
+
+  // one BFS per source; the first link of a path is inherited from the
+  // router it was reached through
+  std::vector<uint32_t> nextLinks (nRouters * nRouters, NO_LINK);
+  std::vector<bool> visited (nRouters);
+  for (uint32_t s = 0; s < nRouters; s++)
+    {
+      uint32_t *next = &nextLinks[s * nRouters];
+      visited.assign (nRouters, false);
+      visited[s] = true;
+      std::queue<uint32_t> queue;
+      queue.push (s);
+      while (!queue.empty ())
+        {
+          uint32_t u = queue.front ();
+          queue.pop ();
+          for (uint32_t l : adjacent[u])
+            {
+              uint32_t v = m_links[l].a == u ? m_links[l].b : m_links[l].a;
+              if (!visited[v])
+                {
+                  visited[v] = true;
+                  next[v] = u == s ? l : next[u];
+                  queue.push (v);
+                }
+            }
+        }
+    }
+  return nextLinks;
+}
+
+std::string
+LanRoutingHelper::GetGraphKey (uint32_t nRouters) const
+{
+  std::ostringstream key;
+  key << nRouters;
+  for (const Link &link : m_links)
+    {
+      key << " " << link.a << "-" << link.b;
+    }
+  return key.str ();
+}
+
+bool
+LanRoutingHelper::LoadNextLinks (std::string key, uint32_t nRouters,
+                                 std::vector<uint32_t> &nextLinks) const
+{
+  std::ostringstream path;
+  path << m_cacheDirectory << "/" << std::hex << std::hash<std::string> () (key) << ".routes";
+  std::ifstream is (path.str ().c_str (), std::ios::binary);
+  if (!is.is_open ())
+    {
+      return false;
+    }
+
+  // the graph key is stored too, so a hash collision is just a miss
+  uint64_t keySize = 0;
+  is.read (reinterpret_cast<char*> (&keySize), sizeof (keySize));
+  std::string storedKey (keySize, ' ');
+  is.read (&storedKey[0], keySize);
+  if (!is || storedKey != key)
+    {
+      return false;
+    }
+  nextLinks.resize (nRouters * nRouters);
+  is.read (reinterpret_cast<char*> (&nextLinks[0]), nextLinks.size () * sizeof (uint32_t));
+  return bool (is);
+}
+
+void
+LanRoutingHelper::SaveNextLinks (std::string key, const std::vector<uint32_t> &nextLinks) const
+{
+  mkdir (m_cacheDirectory.c_str (), 0755);
+  std::ostringstream path, tmpPath;
+  path << m_cacheDirectory << "/" << std::hex << std::hash<std::string> () (key) << ".routes";
+  tmpPath << path.str () << "." << std::dec << getpid ();
+
+  // written aside and renamed, so concurrent workers never read half a file
+  std::ofstream os (tmpPath.str ().c_str (), std::ios::binary | std::ios::trunc);
+  if (!os.is_open ())
+    {
+      NS_LOG_WARN ("Can't write route cache " << tmpPath.str ());
+      return;
+    }
+  uint64_t keySize = key.size ();
+  os.write (reinterpret_cast<const char*> (&keySize), sizeof (keySize));
+  os.write (key.data (), keySize);
+  os.write (reinterpret_cast<const char*> (&nextLinks[0]), nextLinks.size () * sizeof (uint32_t));
+  os.close ();
+  std::rename (tmpPath.str ().c_str (), path.str ().c_str ());
+}
+
+void
+LanRoutingHelper::Populate (NodeContainer routers)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t nRouters = routers.GetN ();
+  std::string key = GetGraphKey (nRouters);
+  std::map<std::string, std::vector<uint32_t> >::iterator cached = s_nextLinks.find (key);
+  if (cached == s_nextLinks.end ())
+    {
+      std::vector<uint32_t> nextLinks;
+      if (m_cacheDirectory.empty () || !LoadNextLinks (key, nRouters, nextLinks))
+        {
+          nextLinks = ComputeNextLinks (nRouters);
+          if (!m_cacheDirectory.empty ())
+            {
+              SaveNextLinks (key, nextLinks);
+            }
+        }
+      cached = s_nextLinks.insert (std::make_pair (key, nextLinks)).first;
+    }
+  const std::vector<uint32_t> &nextLinks = cached->second;
+
+  Ipv4StaticRoutingHelper staticRouting;
+
+  for (const Lan &lan : m_lans)
+    {
+      Ipv4Address gateway = lan.interfaces.GetAddress (0);
+      for (uint32_t i = 1; i < lan.devices.GetN (); i++)
+        {
+          Ptr<Ipv4> ipv4 = lan.devices.Get (i)->GetNode ()->GetObject<Ipv4> ();
+          staticRouting.GetStaticRouting (ipv4)->SetDefaultRoute (
+            gateway, ipv4->GetInterfaceForDevice (lan.devices.Get (i)));
+        }
+    }
+
+  for (uint32_t s = 0; s < nRouters; s++)
+    {
+      Ptr<Ipv4> ipv4 = routers.Get (s)->GetObject<Ipv4> ();
+      Ptr<Ipv4StaticRouting> routing = staticRouting.GetStaticRouting (ipv4);
+      for (const Lan &lan : m_lans)
+        {
+          uint32_t l = nextLinks[s * nRouters + lan.router];
+          if (lan.router == s || l == NO_LINK)
+            {
+              continue;
+            }
+          const Link &link = m_links[l];
+          uint32_t side = link.a == s ? 0 : 1;
+          routing->AddNetworkRouteTo (lan.interfaces.GetAddress (0).CombineMask (lan.mask), lan.mask,
+                                      link.interfaces.GetAddress (1 - side),
+                                      ipv4->GetInterfaceForDevice (link.devices.Get (side)));
+        }
+    }
+
+  NS_LOG_INFO ("Routes for " << m_lans.size () << " LANs behind " << nRouters << " routers");
+}
+
+} // namespace ns3
@@ -0,0 +1,78 @@
+#ifndef LANROUTINGHELPER_H
+#define LANROUTINGHELPER_H
+
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Static routing for networks of routers with a LAN of hosts behind each,
+ * as a cheaper alternative to Ipv4GlobalRoutingHelper::PopulateRoutingTables.
+ *
+ * Shortest paths (in hops, like global routing's unit metrics) are only
+ * computed between routers.  Every router then gets one network route per
+ * remote LAN prefix, and every host gets a default route through its own
+ * router.  The router to router next hop table depends only on the router
+ * graph.  It is memoized in the process, and optionally in a cache
+ * directory so that sweep workers with the same graph share it.
+ *
+ * Equal cost paths are broken by link order, which need not match the
+ * choice global routing makes.  Router link subnets are not routed beyond
+ * their own two routers.
+ */
+class LanRoutingHelper {
+public:
+  LanRoutingHelper ();
+
+  /** "" (the default) keeps the next hop tables in this process only. */
+  void SetCacheDirectory (std::string directory);
+
+  /**
+   * \param devices devices.Get (0) is on router a, devices.Get (1) on router b
+   */
+  void AddRouterLink (uint32_t a, uint32_t b, NetDeviceContainer devices,
+                      Ipv4InterfaceContainer interfaces);
+
+  /**
+   * \param devices devices.Get (0) is the router's, the rest are hosts
+   */
+  void AddLan (uint32_t router, NetDeviceContainer devices, Ipv4InterfaceContainer interfaces,
+               Ipv4Mask mask);
+
+  /** Install the routes; routers.Get (i) is router i. */
+  void Populate (NodeContainer routers);
+
+private:
+  struct Link {
+    uint32_t a, b;
+    NetDeviceContainer devices;
+    Ipv4InterfaceContainer interfaces;
+  };
+  struct Lan {
+    uint32_t router;
+    NetDeviceContainer devices;
+    Ipv4InterfaceContainer interfaces;
+    Ipv4Mask mask;
+  };
+
+  /** \return the index of the first link from s towards d, at s * nRouters + d */
+  std::vector<uint32_t> ComputeNextLinks (uint32_t nRouters) const;
+  std::string GetGraphKey (uint32_t nRouters) const;
+  bool LoadNextLinks (std::string key, uint32_t nRouters, std::vector<uint32_t> &nextLinks) const;
+  void SaveNextLinks (std::string key, const std::vector<uint32_t> &nextLinks) const;
+
+  std::vector<Link> m_links;
+  std::vector<Lan> m_lans;
+  std::string m_cacheDirectory;
+
+  static std::map<std::string, std::vector<uint32_t> > s_nextLinks;
+};
+
+}
+
+#endif
@@ -0,0 +1,135 @@
+#include "lean-packets-helper.h"
+#include "ns3/lr-wpan-net-device.h"
+#include "ns3/packet.h"
+#include "ns3/tag.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/fatal-error.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeanPacketsHelper");
+
+LeanPacketsHelper::LeanPacketsHelper ()
+  : m_filter (Create<Filter> ())
+{
+  NS_LOG_FUNCTION (this);
+  // FlowMonitor's probes tag each IP packet with one of these
+  KeepTag ("ns3::Ipv4FlowProbeTag");
+  KeepTag ("ns3::Ipv6FlowProbeTag");
+}
+
+void
+LeanPacketsHelper::KeepTag (std::string typeName)
+{
+  NS_LOG_FUNCTION (this << typeName);
+  TypeId tid;
+  if (!TypeId::LookupByNameFailSafe (typeName, &tid))
+    {
+      // e.g. the flow monitor module isn't built, so no packet carries it
+      NS_LOG_WARN ("No tag type " << typeName);
+      return;
+    }
+  if (!tid.HasConstructor ())
+    {
+      NS_FATAL_ERROR ("Tag type " << typeName << " can't be kept, it has no constructor");
+    }
+  m_filter->keep.push_back (tid);
+}
+
+void
+LeanPacketsHelper::Install (NetDeviceContainer devices)
+{
+  NS_LOG_FUNCTION (this);
+  for (NetDeviceContainer::Iterator it = devices.Begin (); it != devices.End (); it++)
+    {
+      Ptr<LrWpanNetDevice> device = DynamicCast<LrWpanNetDevice> (*it);
+      NS_ABORT_MSG_IF (device == 0, "LeanPacketsHelper only filters LrWpanNetDevices");
+      // replaces the device's own callback, which Receive then calls
+      device->GetMac ()->SetMcpsDataIndicationCallback (MakeBoundCallback (&LeanPacketsHelper::Receive, m_filter, device));
+    }
+}
+
+uint64_t
+LeanPacketsHelper::GetStrippedTags () const
+{
+  return m_filter->stripped;
+}
+
+void
+LeanPacketsHelper::Receive (Ptr<Filter> filter, Ptr<LrWpanNetDevice> device,
+                            McpsDataIndicationParams params, Ptr<Packet> packet)
+{
+  filter->Strip (packet);
+  device->McpsDataIndication (params, packet);
+}
+
+bool
+LeanPacketsHelper::Filter::IsKept (TypeId tid) const
+{
+  for (const TypeId &kept : keep)
+    {
+      if (kept == tid)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+LeanPacketsHelper::Filter::Strip (Ptr<Packet> packet)
+{
+  bool strip = false;
+  PacketTagIterator tags = packet->GetPacketTagIterator ();
+  while (!strip && tags.HasNext ())
+    {
+      strip = !IsKept (tags.Next ().GetTypeId ());
+    }
+
+  if (strip)
+    {
+      // the list can only be emptied as a whole, so the kept tags are re-added
+      std::vector<Tag *> kept;
+      tags = packet->GetPacketTagIterator ();
+      while (tags.HasNext ())
+        {
+          PacketTagIterator::Item item = tags.Next ();
+          if (IsKept (item.GetTypeId ()))
+            {
+              Callback<ObjectBase *> constructor = item.GetTypeId ().GetConstructor ();
+              Tag *tag = dynamic_cast<Tag *> (constructor ());
+              item.GetTag (*tag);
+              kept.push_back (tag);
+            }
+          else
+            {
+              stripped++;
+            }
+        }
+      packet->RemoveAllPacketTags ();
+      for (Tag *tag : kept)
+        {
+          packet->AddPacketTag (*tag);
+          delete tag;
+        }
+    }
+
+  // byte tags cover byte ranges that can't in general be restored, so
+  // they are only removed if none of them is kept
+  uint64_t byteTags = 0;
+  bool keepBytes = false;
+  ByteTagIterator it = packet->GetByteTagIterator ();
+  while (it.HasNext ())
+    {
+      byteTags++;
+      keepBytes = keepBytes || IsKept (it.Next ().GetTypeId ());
+    }
+  if (byteTags > 0 && !keepBytes)
+    {
+      packet->RemoveAllByteTags ();
+      stripped += byteTags;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,59 @@
+#ifndef LEANPACKETSHELPER_H
+#define LEANPACKETSHELPER_H
+
+#include "ns3/lr-wpan-mac.h"
+#include "ns3/net-device-container.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/type-id.h"
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+class LrWpanNetDevice;
+class Packet;
+
+/**
+ * Strips the tags a throughput-only run doesn't need from every frame an
+ * lr-wpan device receives, before 6LoWPAN reassembles, decompresses or
+ * forwards it.  With mesh-under, each hop would otherwise copy the MAC's
+ * and upper layers' tags into the next transmission.
+ *
+ * Packet tags of the kept types (by default FlowMonitor's flow probe
+ * tags) are re-added.  Byte tags are removed unless one of them is of a
+ * kept type.  Packet metadata needs nothing: it is only recorded once
+ * Packet::EnablePrinting or EnableChecking has been called.
+ */
+class LeanPacketsHelper {
+public:
+  LeanPacketsHelper ();
+
+  /** Also keep tags of this type, e.g. "ns3::LrWpanLqiTag". */
+  void KeepTag (std::string typeName);
+
+  /** Filter what the MACs of these LrWpanNetDevices indicate to their devices. */
+  void Install (NetDeviceContainer devices);
+
+  /** Tags stripped so far, over all installed devices. */
+  uint64_t GetStrippedTags () const;
+
+private:
+  struct Filter : public SimpleRefCount<Filter>
+  {
+    std::vector<TypeId> keep;
+    uint64_t stripped = 0;
+
+    bool IsKept (TypeId tid) const;
+    void Strip (Ptr<Packet> packet);
+  };
+
+  static void Receive (Ptr<Filter> filter, Ptr<LrWpanNetDevice> device,
+                       McpsDataIndicationParams params, Ptr<Packet> packet);
+
+  Ptr<Filter> m_filter;
+};
+
+}
+
+#endif
@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# Per-ACK cost of TcpLrNewReno and wall time of the Task B grid, with the
+# per-ACK logging compiled in and with -DLEAN_LOGGING. Run from the ns-3
+# directory; the build is reconfigured for each mode.
+
+grid="scratch/mywpanB --sweep=n_nodes=1,4 --warmStart=congestionAlgo=TcpLrNewReno;error_rate=0,0.02,0.04,0.06,0.08,0.10 --duration=100"
+
+for flags in "" "-DLEAN_LOGGING"; do
+    echo "CXXFLAGS: ${flags:-(default)}"
+    CXXFLAGS="$flags" ./waf configure --build-profile=debug > /dev/null && ./waf build > /dev/null
+    ./waf --run "scratch/tcp-cc-benchmark --algos=TcpLrNewReno,TcpLrNewReno_4_1_2"
+    start=$(date +%s.%N)
+    ./waf --run "$grid" > /dev/null
+    echo "Task B grid: $(echo "$(date +%s.%N) - $start" | bc) s"
+done
+
+rm -f *.flowstats
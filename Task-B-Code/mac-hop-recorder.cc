@@ -0,0 +1,262 @@
+#include "mac-hop-recorder.h"
+#include "ns3/lr-wpan-net-device.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/fatal-error.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MacHopRecorder");
+
+// records written at a time
+static const uint32_t BufferSize = 4096;
+
+MacHopRecorder::MacHopRecorder (std::string fileName, Time interval)
+  : m_interval (interval.GetNanoSeconds ()),
+    m_begin (0),
+    m_end (0)
+{
+  NS_LOG_FUNCTION (this << fileName << interval);
+  NS_ABORT_MSG_IF (m_interval <= 0, "MAC hop interval must be positive");
+  m_file = std::fopen (fileName.c_str (), "wb");
+  if (m_file == 0)
+    {
+      NS_FATAL_ERROR ("Can't open file " << fileName);
+    }
+  char magic[8] = {'N', 'S', '3', 'M', 'A', 'C', 'H', 0};
+  uint32_t version = 1, recordSize = sizeof (MacHopRecord);
+  std::fwrite (magic, sizeof (magic), 1, m_file);
+  std::fwrite (&version, sizeof (version), 1, m_file);
+  std::fwrite (&recordSize, sizeof (recordSize), 1, m_file);
+  std::fwrite (&m_interval, sizeof (m_interval), 1, m_file);
+  m_buffer.reserve (BufferSize);
+}
+
+MacHopRecorder::~MacHopRecorder ()
+{
+  Close ();
+}
+
+void
+MacHopRecorder::Install (NetDeviceContainer devices)
+{
+  NS_LOG_FUNCTION (this);
+  m_begin = Simulator::Now ().GetNanoSeconds ();
+  for (NetDeviceContainer::Iterator it = devices.Begin (); it != devices.End (); it++)
+    {
+      Ptr<LrWpanNetDevice> device = DynamicCast<LrWpanNetDevice> (*it);
+      NS_ABORT_MSG_IF (device == 0, "MacHopRecorder only records LrWpanNetDevices");
+
+      NodeState *node = new NodeState ();
+      std::memset (&node->record, 0, sizeof (node->record));
+      node->recorder = this;
+      node->start = m_begin;
+      node->lastChange = m_begin;
+      node->queueArea = 0;
+      node->depth = 0;
+      node->active = false;
+      node->dropPending = false;
+      node->state = MAC_IDLE;
+      node->record.node = device->GetNode ()->GetId ();
+      node->total = node->record;
+      m_nodes.push_back (std::unique_ptr<NodeState> (node));
+
+      Ptr<LrWpanMac> mac = device->GetMac ();
+      mac->TraceConnectWithoutContext ("MacTxEnqueue", MakeBoundCallback (&MacHopRecorder::TxEnqueue, node));
+      mac->TraceConnectWithoutContext ("MacTxDequeue", MakeBoundCallback (&MacHopRecorder::TxDequeue, node));
+      mac->TraceConnectWithoutContext ("MacSentPkt", MakeBoundCallback (&MacHopRecorder::SentPacket, node));
+      mac->TraceConnectWithoutContext ("MacTxDrop", MakeBoundCallback (&MacHopRecorder::TxDrop, node));
+      mac->TraceConnectWithoutContext ("MacRxDrop", MakeBoundCallback (&MacHopRecorder::RxDrop, node));
+      mac->TraceConnectWithoutContext ("MacStateValue", MakeBoundCallback (&MacHopRecorder::MacState, node));
+    }
+}
+
+void
+MacHopRecorder::Advance (NodeState &node, int64_t now)
+{
+  while (now >= node.start + m_interval)
+    {
+      int64_t end = node.start + m_interval;
+      Emit (node, end);
+      // nothing can happen in the intervals up to now without an event
+      node.start = node.depth == 0 ? now - (now - end) % m_interval : end;
+      node.lastChange = node.start;
+    }
+  node.queueArea += double (node.depth) * (now - node.lastChange);
+  node.lastChange = now;
+}
+
+void
+MacHopRecorder::Update (NodeState *node)
+{
+  node->recorder->Advance (*node, Simulator::Now ().GetNanoSeconds ());
+  node->active = true;
+}
+
+void
+MacHopRecorder::Emit (NodeState &node, int64_t end)
+{
+  node.queueArea += double (node.depth) * (end - node.lastChange);
+  node.lastChange = end;
+
+  MacHopRecord &record = node.record;
+  if ((node.active || node.depth > 0) && end > node.start)
+    {
+      record.time = node.start;
+      record.endQueue = node.depth;
+      record.meanQueue = node.queueArea / (end - node.start);
+      m_buffer.push_back (record);
+      if (m_buffer.size () == BufferSize)
+        {
+          Flush ();
+        }
+    }
+
+  MacHopRecord &total = node.total;
+  total.maxQueue = std::max (total.maxQueue, record.maxQueue);
+  total.meanQueue += node.queueArea;
+  total.enqueued += record.enqueued;
+  total.sent += record.sent;
+  total.retransmissions += record.retransmissions;
+  total.backoffs += record.backoffs;
+  total.channelAccessDrops += record.channelAccessDrops;
+  total.noAckDrops += record.noAckDrops;
+  total.otherDrops += record.otherDrops;
+  total.rxDrops += record.rxDrops;
+
+  uint32_t id = record.node;
+  std::memset (&record, 0, sizeof (record));
+  record.node = id;
+  record.maxQueue = node.depth;
+  node.queueArea = 0;
+  node.active = false;
+}
+
+void
+MacHopRecorder::Flush ()
+{
+  if (!m_buffer.empty ())
+    {
+      std::fwrite (m_buffer.data (), sizeof (MacHopRecord), m_buffer.size (), m_file);
+      m_buffer.clear ();
+    }
+}
+
+void
+MacHopRecorder::Close ()
+{
+  if (m_file == 0)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  m_end = Simulator::Now ().GetNanoSeconds ();
+  for (std::unique_ptr<NodeState> &node : m_nodes)
+    {
+      Advance (*node, m_end);
+      Emit (*node, m_end);
+    }
+  Flush ();
+  std::fclose (m_file);
+  m_file = 0;
+}
+
+void
+MacHopRecorder::PrintSummary (std::ostream &os) const
+{
+  std::vector<const NodeState *> nodes;
+  for (const std::unique_ptr<NodeState> &node : m_nodes)
+    {
+      nodes.push_back (node.get ());
+    }
+  std::sort (nodes.begin (), nodes.end (), [] (const NodeState *a, const NodeState *b) {
+    return a->total.meanQueue > b->total.meanQueue;
+  });
+
+  double span = std::max<int64_t> (1, m_end - m_begin);
+  for (const NodeState *node : nodes)
+    {
+      const MacHopRecord &total = node->total;
+      os << "MAC Node " << total.node << ": Max Queue " << total.maxQueue
+         << ", Mean Queue " << total.meanQueue / span
+         << ", Sent " << total.sent << ", Retransmissions " << total.retransmissions
+         << ", Backoffs " << total.backoffs
+         << ", Drops (Channel Access " << total.channelAccessDrops << ", No Ack " << total.noAckDrops
+         << ", Other " << total.otherDrops << "), Rx Drops " << total.rxDrops << "\n";
+    }
+}
+
+void
+MacHopRecorder::TxEnqueue (NodeState *node, Ptr<const Packet> packet)
+{
+  Update (node);
+  node->depth++;
+  node->record.enqueued++;
+  node->record.maxQueue = std::max (node->record.maxQueue, node->depth);
+}
+
+void
+MacHopRecorder::TxDequeue (NodeState *node, Ptr<const Packet> packet)
+{
+  Update (node);
+  if (node->depth > 0)
+    {
+      node->depth--;
+    }
+}
+
+void
+MacHopRecorder::SentPacket (NodeState *node, Ptr<const Packet> packet, uint8_t retries, uint8_t backoffs)
+{
+  Update (node);
+  if (node->dropPending)
+    {
+      // the frame TxDrop just counted leaves the queue through here too
+      node->dropPending = false;
+      return;
+    }
+  node->record.sent++;
+  // retries counts the first transmission too
+  node->record.retransmissions += retries > 0 ? retries - 1 : 0;
+  node->record.backoffs += backoffs;
+}
+
+void
+MacHopRecorder::TxDrop (NodeState *node, Ptr<const Packet> packet)
+{
+  Update (node);
+  if (node->state == MAC_CSMA)
+    {
+      node->record.channelAccessDrops++;
+      node->dropPending = true;
+    }
+  else if (node->state == MAC_ACK_PENDING)
+    {
+      node->record.noAckDrops++;
+      node->dropPending = true;
+    }
+  else
+    {
+      node->record.otherDrops++;
+    }
+}
+
+void
+MacHopRecorder::RxDrop (NodeState *node, Ptr<const Packet> packet)
+{
+  Update (node);
+  node->record.rxDrops++;
+}
+
+void
+MacHopRecorder::MacState (NodeState *node, LrWpanMacState oldState, LrWpanMacState newState)
+{
+  // not activity in itself: the MAC changes state for every frame it hears
+  node->state = newState;
+}
+
+} // namespace ns3
@@ -0,0 +1,110 @@
+#ifndef MACHOPRECORDER_H
+#define MACHOPRECORDER_H
+
+#include "ns3/lr-wpan-mac.h"
+#include "ns3/net-device-container.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * One node's MAC activity over one interval, as stored in a .machops file.
+ */
+struct MacHopRecord {
+  int64_t time;                 //!< interval start, ns
+  uint32_t node;
+  uint16_t maxQueue;            //!< deepest the MAC tx queue got
+  uint16_t endQueue;            //!< queue depth at the interval's end
+  double meanQueue;             //!< time averaged queue depth
+  uint32_t enqueued;
+  uint32_t sent;                //!< frames sent (acknowledged, if requested), not the dropped ones
+  uint32_t retransmissions;     //!< of the frames sent
+  uint32_t backoffs;            //!< CSMA/CA backoffs of the frames sent
+  uint32_t channelAccessDrops;  //!< dropped after too many busy CCAs
+  uint32_t noAckDrops;          //!< dropped after the last retransmission
+  uint32_t otherDrops;
+  uint32_t rxDrops;             //!< received frames the MAC discarded
+};
+
+static_assert (sizeof (MacHopRecord) == 56, "MacHopRecord must stay 56 bytes");
+
+/**
+ * Per-hop MAC and queue time series for lr-wpan devices.
+ *
+ * FlowMonitor only sees packets end to end.  This connects to the trace
+ * sources of each device's LrWpanMac and keeps, per node and interval,
+ * the tx queue depth (maximum, time average and final), frames enqueued
+ * and sent, retransmissions and CSMA/CA backoffs, and drops by reason.
+ * The MAC doesn't pass a drop reason, so it is inferred from the MAC
+ * state at the drop: still in CSMA/CA means the channel access failed,
+ * waiting for an ACK means the retransmissions ran out.  The MAC reports
+ * such a dropped frame as sent right after the drop; that report is
+ * skipped, so a frame is counted either as sent or as dropped.
+ *
+ * Each trace event only updates counters.  A node's interval is closed
+ * on its first event after the interval ends, and written, if anything
+ * happened in it, as a MacHopRecord.  The file starts with a 24 byte
+ * header ("NS3MACH", then uint32 version and record size, then the
+ * interval in ns as int64).  Records are in time order per node.
+ */
+class MacHopRecorder {
+public:
+  MacHopRecorder (std::string fileName, Time interval);
+  ~MacHopRecorder ();
+
+  /** Record the MACs of these LrWpanNetDevices. */
+  void Install (NetDeviceContainer devices);
+
+  /** Write the current intervals and close the file; call before Simulator::Destroy. */
+  void Close ();
+
+  /** One line per node of run totals, busiest queue first. */
+  void PrintSummary (std::ostream &os) const;
+
+private:
+  struct NodeState
+  {
+    MacHopRecorder *recorder;
+    int64_t start;               //!< of the current interval
+    int64_t lastChange;          //!< of the queue depth
+    double queueArea;            //!< depth x ns, this interval
+    uint16_t depth;
+    bool active;
+    bool dropPending;            //!< the next MacSentPkt is the dropped frame's
+    LrWpanMacState state;
+    MacHopRecord record;         //!< this interval's counters
+    MacHopRecord total;          //!< the run's, meanQueue as depth x ns
+  };
+
+  static void TxEnqueue (NodeState *node, Ptr<const Packet> packet);
+  static void TxDequeue (NodeState *node, Ptr<const Packet> packet);
+  static void SentPacket (NodeState *node, Ptr<const Packet> packet, uint8_t retries, uint8_t backoffs);
+  static void TxDrop (NodeState *node, Ptr<const Packet> packet);
+  static void RxDrop (NodeState *node, Ptr<const Packet> packet);
+  static void MacState (NodeState *node, LrWpanMacState oldState, LrWpanMacState newState);
+
+  /** Close the node's intervals that ended before now and account the queue up to now. */
+  void Advance (NodeState &node, int64_t now);
+  /** Advance the node to now, for an event in the current interval. */
+  static void Update (NodeState *node);
+  void Emit (NodeState &node, int64_t end);
+  void Flush ();
+
+  std::FILE *m_file;
+  int64_t m_interval;
+  int64_t m_begin;
+  int64_t m_end;
+  std::vector<std::unique_ptr<NodeState> > m_nodes;
+  std::vector<MacHopRecord> m_buffer;
+};
+
+}
+
+#endif
@@ -0,0 +1,32 @@
+import os
+import numpy as np
+import pandas as pd
+
+# layout of the MacHopRecords in the .machops files written by mywpanB --macHops
+MACHOP_RECORD = np.dtype([('time', '<i8'), ('node', '<u4'), ('maxQueue', '<u2'), ('endQueue', '<u2'),
+                          ('meanQueue', '<f8'), ('enqueued', '<u4'), ('sent', '<u4'),
+                          ('retransmissions', '<u4'), ('backoffs', '<u4'), ('channelAccessDrops', '<u4'),
+                          ('noAckDrops', '<u4'), ('otherDrops', '<u4'), ('rxDrops', '<u4')])
+
+def load_machops(path):
+    magic = np.fromfile(path, dtype='S8', count=1)[0]
+    if magic != b'NS3MACH':
+        raise ValueError(path + " is not a .machops file")
+    records = np.fromfile(path, dtype=MACHOP_RECORD, offset=24)
+    # each node's records are in order, but nodes are interleaved
+    return records[np.lexsort((records['time'], records['node']))]
+
+for f in os.listdir():
+    if f.endswith(".machops"):
+        records = load_machops(f)
+        # Sent, Retransmissions and Backoffs are of the frames that got through;
+        # a dropped frame only counts in its drop column
+        df = pd.DataFrame({'Node': records['node'], 'Time': records['time']*1e-9,
+                           'Max Queue': records['maxQueue'], 'Mean Queue': records['meanQueue'],
+                           'End Queue': records['endQueue'], 'Enqueued': records['enqueued'],
+                           'Sent': records['sent'], 'Retransmissions': records['retransmissions'],
+                           'Backoffs': records['backoffs'],
+                           'Channel Access Drops': records['channelAccessDrops'],
+                           'No Ack Drops': records['noAckDrops'], 'Other Drops': records['otherDrops'],
+                           'Rx Drops': records['rxDrops']})
+        df.to_csv(f[:-len(".machops")] + "-machops.csv", index=False)
@@ -10,18 +10,43 @@
 #include "ns3/applications-module.h"
 #include "ns3/ipv6-flow-classifier.h"
 #include "ns3/flow-monitor-helper.h"
+#include "ns3/sweep-runner.h"
+#include "ns3/flow-stats-file.h"
+#include "ns3/flow-metrics-aggregator.h"
+#include "ns3/tcp-ack-trace.h"
+#include "ns3/cwnd-trace-recorder.h"
+#include "ns3/packet-buffer-pool.h"
+#include "ns3/lean-packets-helper.h"
+#include "ns3/convergence-monitor.h"
+#include "ns3/mac-hop-recorder.h"
 #include <ns3/lr-wpan-error-model.h>
 #include "ns3/error-model.h"
 #include <string>
+#include <algorithm>
 #include <cmath>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
 using namespace std;
 using namespace ns3;
 
-uint n_flows=3, n_nodes=5, sinkPort=9;
+uint n_flows=3, n_nodes=5, sinkPort=9, gateways=1;
 uint start_time=0, stop_time, duration=100, pkt_sz=100;
-bool verbose = false;
-string filePrefix, congestionAlgo = "TcpNewReno", recoveryAlgo="ns3::TcpClassicRecovery";
-double error_rate = 0.00; 
+bool verbose = false, fixedPoint = false, recordAckTrace = false, cwndTrace = false, profile = false, packetPool = false, leanPackets = false, macHops = false;
+string filePrefix, summaryCsv, warmStart, flowFormat = "bin", gatewayAssign = "nearest", congestionAlgo = "TcpNewReno", recoveryAlgo="ns3::TcpClassicRecovery";
+double error_rate = 0.00, convergeTarget = 0, convergeInterval = 1, macHopInterval = 0.1; 
+
+ofstream ackTraceStream;
+map<uint, int64_t> lastRtt;
+
+// what warm started variants change after the fork
+RateErrorModel* errorModel;
+FlowMonitorHelper* flowHelper;
+LeanPacketsHelper* leanHelper;
+NetDeviceContainer* lrwpanDevices;
+ApplicationContainer* sourceApplications;
+vector<string> pointArgs;
 
 void processArguments(int argc, char** argv) {
     CommandLine cmd (__FILE__);
@@ -31,9 +56,43 @@ void processArguments(int argc, char** argv) {
     cmd.AddValue ("n_nodes", "Number of Nodes", n_nodes);
     cmd.AddValue ("verbose", "Print In Console", verbose);
     cmd.AddValue ("duration", "Duration", duration);
+    cmd.AddValue ("flowFormat", "FlowMonitor Output (bin or xml)", flowFormat);
+    cmd.AddValue ("summaryCsv", "Append Run Metrics To CSV", summaryCsv);
     cmd.AddValue ("error_rate", "Error Rate", error_rate);
+    cmd.AddValue ("fixedPoint", "Integer TcpLrNewReno Window Update", fixedPoint);
+    cmd.AddValue ("recordAckTrace", "Record Each Flow's ACK/Loss Process", recordAckTrace);
+    cmd.AddValue ("cwndTrace", "Binary TcpLrNewReno cwnd/ssthresh/CW_MAX/Ideal_CW Trace", cwndTrace);
+    cmd.AddValue ("profile", "Print Per-Source Event Counts And Wall Time At Destroy", profile);
+    cmd.AddValue ("packetPool", "Pool Packet, Tag And Event Allocations While Running", packetPool);
+    cmd.AddValue ("leanPackets", "Strip Tags FlowMonitor Doesn't Need At Each Hop", leanPackets);
+    cmd.AddValue ("macHops", "Record Per-Node MAC Queue, Backoff, Retransmission And Drop Time Series", macHops);
+    cmd.AddValue ("macHopInterval", "MAC Time Series Interval In Seconds", macHopInterval);
+    cmd.AddValue ("convergeTarget", "Stop Once The Throughput And Delay 95% CIs Are Within This Fraction (0 = Off)", convergeTarget);
+    cmd.AddValue ("convergeInterval", "Convergence Sampling Interval In Seconds", convergeInterval);
+    cmd.AddValue ("gateways", "Number of Border Routers, Each With Its Own Uplink And Sink", gateways);
+    cmd.AddValue ("gatewayAssign", "Gateway Of Each Flow (nearest or hash)", gatewayAssign);
+    cmd.AddValue ("warmStart", "Variants Forked After Warm-up, e.g. congestionAlgo=TcpNewReno,TcpVegas;error_rate=0,0.02", warmStart);
     cmd.Parse (argc, argv);
 
+    // takes effect when the first event is scheduled
+    if( profile ) GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::ProfilingSimulatorImpl"));
+
+    // only these don't take effect before the sources start
+    istringstream axes(warmStart);
+    string axis;
+    while( getline(axes, axis, ';') ) {
+        string name = axis.substr(0, axis.find('='));
+        if( name!="congestionAlgo" && name!="error_rate" && name!="fixedPoint" ) {
+            std::cout << "Can't Warm Start Over " << name << "\n";
+            exit(0);
+        }
+    }
+    // the variants' runs are not reported back to the replication runner
+    if( warmStart!="" && SweepRunner::IsReplicating() ) {
+        std::cout << "Can't Combine --warmStart With --replications\n";
+        exit(0);
+    }
+
     n_flows = n_nodes;
 
     if( n_nodes<1 ) {
@@ -48,9 +107,22 @@ void processArguments(int argc, char** argv) {
         std::cout << "Minimum 10s Duration Required\n";
         exit(0);
     }
+    else if( gateways<1 ) {
+        std::cout << "Minimum 1 Gateway Required\n";
+        exit(0);
+    }
+    else if( gateways>n_nodes ) {
+        std::cout << "At Most " << n_nodes << " Gateways For " << n_nodes << " Nodes\n";
+        exit(0);
+    }
+    else if( gatewayAssign!="nearest" && gatewayAssign!="hash" ) {
+        std::cout << "Unknown Gateway Assignment " << gatewayAssign << "\n";
+        exit(0);
+    }
 
     std::cout << "\n--------------------------------------------------------------------------\n";
     std::cout << "Nodes: " << n_nodes << ", Error Rate: " << error_rate << ", CongestionAlgo: " << congestionAlgo;
+    if( gateways>1 ) std::cout << ", Gateways: " << gateways << " (" << gatewayAssign << ")";
     std::cout << "\n--------------------------------------------------------------------------\n\n";
 
     if(verbose) LogComponentEnable("PacketSink", LOG_LEVEL_INFO);
@@ -58,10 +130,11 @@ void processArguments(int argc, char** argv) {
     stop_time = start_time + duration + 2;
 
     filePrefix = "wpanB-"+congestionAlgo+"-"+to_string(n_nodes)+"-"+to_string(int(error_rate*100));
+    if( gateways>1 ) filePrefix += "-gw"+to_string(gateways);
 
-    congestionAlgo = "ns3::" + congestionAlgo;
-    Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue (congestionAlgo));
+    Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue ("ns3::" + congestionAlgo));
     Config::SetDefault ("ns3::TcpL4Protocol::RecoveryType", StringValue (recoveryAlgo));  
+    Config::SetDefault ("ns3::TcpLrNewReno::FixedPoint", BooleanValue (fixedPoint));
     Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (1 << 22));
     Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (1 << 22));
     Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (true));
@@ -70,19 +143,183 @@ void processArguments(int argc, char** argv) {
     Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (pkt_sz));
 }
 
-int main (int argc, char** argv) {
+// the ACK/loss process of each source socket, for tcp-cc-replay
+void traceAck(uint flow, SequenceNumber32 oldAck, SequenceNumber32 newAck) {
+    // the first advance only acknowledges the SYN
+    if( oldAck==SequenceNumber32 (0) || newAck<=oldAck ) return;
+    TcpAckEvent event;
+    event.flow = flow;
+    event.time = Simulator::Now ().GetNanoSeconds ();
+    event.segmentsAcked = (uint32_t (newAck-oldAck) + pkt_sz - 1) / pkt_sz;
+    event.rtt = lastRtt[flow];
+    TcpAckTrace::Write(ackTraceStream, event);
+}
+
+void traceRtt(uint flow, Time oldRtt, Time newRtt) {
+    lastRtt[flow] = newRtt.GetNanoSeconds ();
+}
+
+void traceCongState(uint flow, TcpSocketState::TcpCongState_t oldState, TcpSocketState::TcpCongState_t newState) {
+    bool wasRecovering = oldState==TcpSocketState::CA_RECOVERY || oldState==TcpSocketState::CA_LOSS;
+    bool isRecovering = newState==TcpSocketState::CA_RECOVERY || newState==TcpSocketState::CA_LOSS;
+    // a timeout during fast recovery reduces the window a second time
+    bool timedOut = newState==TcpSocketState::CA_LOSS && oldState!=TcpSocketState::CA_LOSS;
+    if( (wasRecovering || !isRecovering) && !timedOut ) return;
+    TcpAckEvent event;
+    event.flow = flow;
+    event.type = TcpAckEvent::LOSS;
+    event.time = Simulator::Now ().GetNanoSeconds ();
+    TcpAckTrace::Write(ackTraceStream, event);
+}
+
+void connectAckTrace(uint flow, Ptr<Application> app) {
+    if( !ackTraceStream.is_open() ) ackTraceStream.open (filePrefix + ".acktrace");
+    Ptr<Socket> socket = DynamicCast<BulkSendApplication> (app)->GetSocket ();
+    socket->TraceConnectWithoutContext ("HighestRxAck", MakeBoundCallback (&traceAck, flow));
+    socket->TraceConnectWithoutContext ("RTT", MakeBoundCallback (&traceRtt, flow));
+    socket->TraceConnectWithoutContext ("CongState", MakeBoundCallback (&traceCongState, flow));
+}
+
+// at convergence, what the sources' stop at stop_time-10 would do: no
+// new data, while what TCP has buffered still goes out
+void stopSources() {
+    for( uint i=0; i<sourceApplications->GetN(); i++ ) {
+        Ptr<Socket> socket = DynamicCast<BulkSendApplication> (sourceApplications->Get (i))->GetSocket ();
+        if( socket ) socket->ShutdownSend ();
+    }
+}
+
+// runs up to the stop time and writes the results
+void finishSimulation() {
+    if( cwndTrace ) CwndTraceRecorder::Enable (filePrefix + ".cwnd");
+
+    // after a warm start's fork, so each variant writes its own file
+    unique_ptr<MacHopRecorder> macHopRecorder;
+    if( macHops ) {
+        macHopRecorder.reset (new MacHopRecorder (filePrefix + ".machops", Seconds (macHopInterval)));
+        macHopRecorder->Install (*lrwpanDevices);
+    }
+
+    // the sources start after a warm start's fork, so this holds for every variant
+    ConvergenceMonitor convergence (flowHelper->GetMonitor ());
+    if( convergeTarget>0 ) {
+        convergence.SetTarget (convergeTarget);
+        convergence.SetInterval (Seconds (convergeInterval));
+        convergence.SetDrain (Seconds (10), MakeCallback (&stopSources));
+        convergence.Start (Seconds (start_time+10));
+    }
+
+    // setup and post-processing allocate from malloc
+    if( packetPool ) PacketBufferPool::Enable ();
+    Simulator::Run ();
+    if( packetPool ) PacketBufferPool::Disable ();
+
+    if( convergeTarget>0 ) convergence.PrintReport (std::cout);
+    if( macHops ) {
+        macHopRecorder->Close ();
+        macHopRecorder->PrintSummary (std::cout);
+    }
+
+    CwndTraceRecorder::Disable ();
+
+    if( packetPool ) PacketBufferPool::PrintStats (std::cout);
+    if( leanPackets ) std::cout << "Lean Packets: " << leanHelper->GetStrippedTags () << " Tags Stripped\n";
+
+    if( flowFormat=="xml" ) flowHelper->SerializeToXmlFile (filePrefix + ".flowmonitor", true, true);
+    else FlowStatsFile::Serialize (flowHelper->GetMonitor (), filePrefix + ".flowstats");
+
+    if( SweepRunner::IsReplicating () ) {
+        FlowMetricsAggregator aggregator (flowHelper->GetMonitor ());
+        aggregator.SetSkipIdleFlows (true);
+        FlowMetrics metrics = aggregator.Summarize ();
+        SweepRunner::Report ({{"Throughput", metrics.throughput}, {"Delay", metrics.delay}});
+    }
+
+    if( summaryCsv!="" ) {
+        FlowMetricsAggregator aggregator (flowHelper->GetMonitor ());
+        aggregator.SetSkipIdleFlows (true);
+        aggregator.AppendCsvRow (summaryCsv, {{"Algo", congestionAlgo}, {"Nodes", to_string(n_nodes)},
+                                              {"Error Rate", to_string(int(error_rate*100))},
+                                              {"Gateways", to_string(gateways)}});
+    }
+
+    if( ackTraceStream.is_open() ) ackTraceStream.close ();
+
+    Simulator::Destroy ();
+}
+
+void resumeVariant(int argc, char** argv) {
     processArguments(argc, argv);
+    Config::Set ("/NodeList/*/$ns3::TcpL4Protocol/SocketType", TypeIdValue (TypeId::LookupByName ("ns3::" + congestionAlgo)));
+    errorModel->SetRate (error_rate);
+    finishSimulation();
+}
+
+/*
+    Nothing up to the sources and sinks starting at start_time+10 depends
+    on the congestion algorithm or the error rate: no TCP socket exists
+    yet, and the error model draws the same random numbers at any rate
+    while only neighbour discovery crosses the p2p link. So the setup and
+    warm-up are simulated once and every variant is forked from that
+    state, with the stop event already in place as in a cold run. Inside
+    a sweep worker, the variants share that worker's part of --jobs.
+*/
+void warmUp() {
+    Simulator::Schedule (Seconds (start_time+10) - NanoSeconds (1), static_cast<void (*)(void)> (&Simulator::Stop));
+    Simulator::Run ();
+
+    vector<char*> argv;
+    for( string& arg : pointArgs ) argv.push_back(&arg[0]);
+
+    SweepRunner variants;
+    variants.SetBaseArgs(argv.size(), argv.data());
+    variants.AddAxes(warmStart);
+    int failed = variants.Run(MakeCallback(&resumeVariant));
 
+    Simulator::Destroy ();
+    if( failed ) exit(1);
+}
+
+// placeGateways, assignGateway and the gateway routes in runSimulation are the same
+// in mywpan4.cc; change both together
+// border routers spread evenly along the line, a single one stays at the center
+vector<uint> placeGateways(uint centerNode) {
+    vector<uint> gatewayNodes;
+    if( gateways==1 ) gatewayNodes.push_back(centerNode);
+    else for( uint g=0; g<gateways; g++ ) gatewayNodes.push_back(((2*g+1)*(n_nodes+1))/(2*gateways));
+    return gatewayNodes;
+}
+
+// the uplink a flow leaves through: the border router closest to its
+// source, or a hash of the flow, which also spreads one node's flows
+uint assignGateway(NodeContainer& wirelessNodes, vector<uint>& gatewayNodes, uint sourceNode, uint flow) {
+    if( gatewayAssign=="hash" ) return ((sourceNode*31+flow)*2654435761u >> 16) % gatewayNodes.size();
+
+    Ptr<MobilityModel> source = wirelessNodes.Get (sourceNode)->GetObject<MobilityModel> ();
+    uint nearest = 0;
+    double nearestDistance = source->GetDistanceFrom (wirelessNodes.Get (gatewayNodes[0])->GetObject<MobilityModel> ());
+    for( uint g=1; g<gatewayNodes.size(); g++ ) {
+        double distance = source->GetDistanceFrom (wirelessNodes.Get (gatewayNodes[g])->GetObject<MobilityModel> ());
+        if( distance<nearestDistance ) {
+            nearest = g;
+            nearestDistance = distance;
+        }
+    }
+    return nearest;
+}
+
+void runSimulation() {
     NodeContainer wirelessNodes;
     wirelessNodes.Create (n_nodes+1);
 
     uint centerNode;
     if(n_nodes==1) centerNode=1;
     else centerNode = n_nodes/2;
+    vector<uint> gatewayNodes = placeGateways(centerNode);
 
+    // one wired sink behind each border router
     NodeContainer wiredNodes;
-    wiredNodes.Create (1);
-    wiredNodes.Add (wirelessNodes.Get (centerNode));
+    wiredNodes.Create (gateways);
 
     InternetStackHelper internetv6;
     internetv6.InstallAll();
@@ -102,6 +339,9 @@ int main (int argc, char** argv) {
     NetDeviceContainer lrwpanNetDevices = lrWpanHelper.Install (wirelessNodes);
     lrWpanHelper.AssociateToPan (lrwpanNetDevices, 0);
 
+    LeanPacketsHelper leanPacketsHelper;
+    if( leanPackets ) leanPacketsHelper.Install (lrwpanNetDevices);
+
     SixLowPanHelper sixLowPanHelper;
     NetDeviceContainer sixLowPanNetDevices = sixLowPanHelper.Install (lrwpanNetDevices);
 
@@ -116,20 +356,35 @@ int main (int argc, char** argv) {
     p2pHelper.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
     p2pHelper.SetChannelAttribute ("Delay", StringValue ("0.01ms"));
     p2pHelper.SetDeviceAttribute ("ReceiveErrorModel", PointerValue (&error_model));
-    NetDeviceContainer p2pDevices = p2pHelper.Install (wiredNodes);
 
     Ipv6AddressHelper ipv6;
     ipv6.SetBase (Ipv6Address ("2001:cafe::"), Ipv6Prefix (64));
-    Ipv6InterfaceContainer wiredDeviceInterfaces;
-    wiredDeviceInterfaces = ipv6.Assign (p2pDevices);
-    wiredDeviceInterfaces.SetForwarding (1, true);
-    wiredDeviceInterfaces.SetDefaultRouteInAllNodes (1);
+    vector<Ipv6InterfaceContainer> wiredDeviceInterfaces;
+    for( uint g=0; g<gateways; g++ ) {
+        NetDeviceContainer p2pDevices = p2pHelper.Install (wiredNodes.Get (g), wirelessNodes.Get (gatewayNodes[g]));
+        if( g>0 ) ipv6.NewNetwork();
+        wiredDeviceInterfaces.push_back (ipv6.Assign (p2pDevices));
+        wiredDeviceInterfaces[g].SetForwarding (1, true);
+        wiredDeviceInterfaces[g].SetDefaultRouteInAllNodes (1);
+    }
 
     ipv6.NewNetwork();
     Ipv6InterfaceContainer wsnDeviceInterfaces;
     wsnDeviceInterfaces = ipv6.Assign (sixLowPanNetDevices);
-    wsnDeviceInterfaces.SetForwarding (centerNode, true);
-    wsnDeviceInterfaces.SetDefaultRouteInAllNodes (centerNode);
+    for( uint g=0; g<gateways; g++ ) wsnDeviceInterfaces.SetForwarding (gatewayNodes[g], true);
+    wsnDeviceInterfaces.SetDefaultRouteInAllNodes (gatewayNodes[0]);
+
+    // the other uplinks' networks are routed through their own border router
+    Ipv6StaticRoutingHelper routingHelper;
+    for( uint g=1; g<gateways; g++ ) {
+        Ipv6Address uplinkNetwork = wiredDeviceInterfaces[g].GetAddress (0, 1).CombinePrefix (Ipv6Prefix (64));
+        for( uint n=0; n<=n_nodes; n++ ) {
+            if( n==gatewayNodes[g] ) continue;
+            Ptr<Ipv6StaticRouting> routing = routingHelper.GetStaticRouting (wirelessNodes.Get (n)->GetObject<Ipv6> ());
+            routing->AddNetworkRouteTo (uplinkNetwork, Ipv6Prefix (64), wsnDeviceInterfaces.GetLinkLocalAddress (gatewayNodes[g]),
+                                        wsnDeviceInterfaces.GetInterfaceIndex (n));
+        }
+    }
 
     for (uint32_t i = 0; i < sixLowPanNetDevices.GetN (); i++) {
         Ptr<NetDevice> dev = sixLowPanNetDevices.Get (i);
@@ -140,8 +395,11 @@ int main (int argc, char** argv) {
     PacketSinkHelper sinkApp ("ns3::TcpSocketFactory",
     Inet6SocketAddress (Ipv6Address::GetAny (), sinkPort));
     sinkApp.SetAttribute ("Protocol", TypeIdValue (TcpSocketFactory::GetTypeId ()));
-    ApplicationContainer sinkApps = sinkApp.Install (wiredNodes.Get(0));
-    sinkApps.Start (Seconds (start_time+5));
+    ApplicationContainer sinkApps = sinkApp.Install (wiredNodes);
+    // the listening sockets take the congestion algorithm too, so they are
+    // only created after a warm start's fork, with the sources; a SYN takes
+    // at least one hop to reach them
+    sinkApps.Start (Seconds (start_time+10));
     sinkApps.Stop (Seconds (stop_time-5));
 
     vector<uint> sources; 
@@ -156,31 +414,86 @@ int main (int argc, char** argv) {
             if( j<n_nodes ) j++;
         } 
     }
+    // the center node sends as well once it's no border router
+    if( gateways>1 ) {
+        sources.insert(sources.begin(), centerNode);
+        for( uint g : gatewayNodes ) sources.erase(remove(sources.begin(), sources.end(), g), sources.end());
+    }
+
+    vector<uint> gatewayFlows (gateways, 0);
+    ApplicationContainer allSourceApps;
 
     for( uint i=1, sourceNode=0; i<=n_flows; ) {
+        uint gateway = assignGateway(wirelessNodes, gatewayNodes, sources[sourceNode], i);
+        gatewayFlows[gateway]++;
         BulkSendHelper sourceApp ("ns3::TcpSocketFactory",
-                                    Inet6SocketAddress (wiredDeviceInterfaces.GetAddress (0, 1), 
+                                    Inet6SocketAddress (wiredDeviceInterfaces[gateway].GetAddress (0, 1), 
                                     sinkPort));
         sourceApp.SetAttribute ("SendSize", UintegerValue (pkt_sz));
         sourceApp.SetAttribute ("MaxBytes", UintegerValue (0));
         ApplicationContainer sourceApps = sourceApp.Install (wirelessNodes.Get (sources[sourceNode]));
         sourceApps.Start (Seconds (start_time+10));
         sourceApps.Stop (Seconds (stop_time-10));
+        allSourceApps.Add (sourceApps);
+
+        // the socket exists once the application has started
+        if( recordAckTrace )
+            Simulator::Schedule (Seconds (start_time+10) + NanoSeconds (1), &connectAckTrace, i-1, sourceApps.Get (0));
 
         i++;
         if( sourceNode==sources.size()-1 ) sourceNode=0;
         else sourceNode++;
     }
+    if( gateways>1 ) {
+        std::cout << "Flows Per Gateway:";
+        for( uint g=0; g<gateways; g++ ) std::cout << " " << gatewayFlows[g] << "@" << gatewayNodes[g];
+        std::cout << "\n";
+    }
     
-    FlowMonitorHelper flowHelper;
-    flowHelper.InstallAll ();
+    FlowMonitorHelper monitorHelper;
+    // one histogram bin each, FlowMonitor's counters are all the run needs
+    if( leanPackets ) {
+        monitorHelper.SetMonitorAttribute ("DelayBinWidth", DoubleValue (stop_time));
+        monitorHelper.SetMonitorAttribute ("JitterBinWidth", DoubleValue (stop_time));
+        monitorHelper.SetMonitorAttribute ("PacketSizeBinWidth", DoubleValue (65536));
+        monitorHelper.SetMonitorAttribute ("FlowInterruptionsBinWidth", DoubleValue (stop_time));
+    }
+    monitorHelper.InstallAll ();
+    flowHelper = &monitorHelper;
+    leanHelper = &leanPacketsHelper;
+    lrwpanDevices = &lrwpanNetDevices;
+    sourceApplications = &allSourceApps;
+    errorModel = &error_model;
 
     Simulator::Stop (Seconds (stop_time));
-    Simulator::Run ();
 
-    flowHelper.SerializeToXmlFile (filePrefix + ".flowmonitor", true, true);
+    if( warmStart!="" ) {
+        warmUp();
+        return;
+    }
+
+    finishSimulation();
+}
 
-    Simulator::Destroy ();
+// --batch runs points back to back in one process: what SweepRunner
+// doesn't reset, and the arguments don't set again, starts over here
+void resetScenario() {
+    Ipv6AddressGenerator::Reset ();
+    lastRtt.clear();
+}
+
+void runPoint(int argc, char** argv) {
+    resetScenario();
+    pointArgs.assign(argv, argv+argc);
+    processArguments(argc, argv);
+    runSimulation();
+}
+
+int main (int argc, char** argv) {
+    SweepRunner sweep;
+    if( sweep.Parse(argc, argv) ) return sweep.Run(MakeCallback(&runPoint));
+
+    runPoint(argc, argv);
 
     return 0;
 }
@@ -0,0 +1,197 @@
+#include "packet-buffer-pool.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <sys/mman.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PacketBufferPool");
+
+namespace {
+
+// all constant initialized, since the replaced operator new runs before any static constructor
+const std::size_t ClassSize = 16;
+const std::size_t NClasses = PacketBufferPool::MaxSize / ClassSize + 1;
+const std::size_t ChunkSize = 64 * 1024;
+const std::size_t RangeSize = std::size_t (16) << 30;
+
+struct Block
+{
+  Block *next;
+};
+
+std::atomic<char *> g_base (0);   //!< start of the reserved range, set once
+char *g_top = 0;                  //!< first chunk not yet carved
+uint8_t g_chunkClass[RangeSize / ChunkSize];
+
+Block *g_free[NClasses];
+char *g_cursor[NClasses];         //!< next block of the class's current chunk
+char *g_end[NClasses];
+
+bool g_enabled = false;
+bool g_operatorsInstalled = false;
+thread_local bool t_owner = false;
+
+// blocks freed on other threads, put back on the lists by the owner
+std::mutex g_remoteLock;
+Block *g_remote = 0;
+std::atomic<bool> g_hasRemote (false);
+
+PacketBufferPool::Stats g_stats;
+
+std::size_t
+ChunkClass (const void *p)
+{
+  return g_chunkClass[(static_cast<const char *> (p) - g_base.load (std::memory_order_relaxed)) / ChunkSize];
+}
+
+void
+ReclaimRemote ()
+{
+  std::lock_guard<std::mutex> lock (g_remoteLock);
+  while (g_remote != 0)
+    {
+      Block *block = g_remote;
+      g_remote = block->next;
+      std::size_t c = ChunkClass (block);
+      block->next = g_free[c];
+      g_free[c] = block;
+    }
+  g_hasRemote.store (false, std::memory_order_relaxed);
+}
+
+} // anonymous namespace
+
+void
+PacketBufferPool::Enable ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  NS_ABORT_MSG_IF (!g_operatorsInstalled, "PacketBufferPool needs packet-pool-operators.cc "
+                   "built into the program, next to the scenario in its scratch directory");
+  if (g_base.load () == 0)
+    {
+      // address space only; pages are committed as chunks are carved
+      void *range = mmap (0, RangeSize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      if (range == MAP_FAILED)
+        {
+          NS_LOG_WARN ("Can't reserve the pool's address range, allocating with malloc");
+          return;
+        }
+      g_top = static_cast<char *> (range);
+      g_base.store (g_top);
+    }
+  t_owner = true;
+  g_enabled = true;
+}
+
+void
+PacketBufferPool::Disable ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_enabled = false;
+}
+
+void
+PacketBufferPool::SetOperatorsInstalled ()
+{
+  g_operatorsInstalled = true;
+}
+
+bool
+PacketBufferPool::IsEnabled ()
+{
+  return g_enabled;
+}
+
+PacketBufferPool::Stats
+PacketBufferPool::GetStats ()
+{
+  return g_stats;
+}
+
+void
+PacketBufferPool::PrintStats (std::ostream &os)
+{
+  os << "Packet Buffer Pool: " << g_stats.allocations << " allocations, "
+     << (g_stats.allocations ? 100.0 * g_stats.reused / g_stats.allocations : 0) << "% reused, "
+     << g_stats.reservedBytes / (1024 * 1024) << " MB in chunks, "
+     << g_stats.fallbacks << " fallbacks\n";
+}
+
+void *
+PacketBufferPool::Allocate (std::size_t size)
+{
+  if (g_enabled && t_owner && size <= MaxSize)
+    {
+      std::size_t c = size == 0 ? 1 : (size + ClassSize - 1) / ClassSize;
+      if (g_free[c] == 0 && g_hasRemote.load (std::memory_order_relaxed))
+        {
+          ReclaimRemote ();
+        }
+
+      Block *block = g_free[c];
+      if (block != 0)
+        {
+          g_free[c] = block->next;
+          g_stats.allocations++;
+          g_stats.reused++;
+          return block;
+        }
+
+      if (g_cursor[c] == g_end[c])
+        {
+          char *base = g_base.load (std::memory_order_relaxed);
+          if (std::size_t (g_top - base) + ChunkSize <= RangeSize)
+            {
+              std::size_t blockSize = c * ClassSize;
+              g_chunkClass[(g_top - base) / ChunkSize] = c;
+              g_cursor[c] = g_top;
+              g_end[c] = g_top + ChunkSize / blockSize * blockSize;
+              g_top += ChunkSize;
+              g_stats.reservedBytes += ChunkSize;
+            }
+          else
+            {
+              g_stats.fallbacks++;
+              return std::malloc (size);
+            }
+        }
+
+      void *p = g_cursor[c];
+      g_cursor[c] += c * ClassSize;
+      g_stats.allocations++;
+      return p;
+    }
+  return std::malloc (size == 0 ? 1 : size);
+}
+
+void
+PacketBufferPool::Free (void *p)
+{
+  std::uintptr_t base = reinterpret_cast<std::uintptr_t> (g_base.load (std::memory_order_relaxed));
+  if (base != 0 && reinterpret_cast<std::uintptr_t> (p) - base < RangeSize)
+    {
+      Block *block = static_cast<Block *> (p);
+      if (t_owner)
+        {
+          std::size_t c = ChunkClass (p);
+          block->next = g_free[c];
+          g_free[c] = block;
+        }
+      else
+        {
+          std::lock_guard<std::mutex> lock (g_remoteLock);
+          block->next = g_remote;
+          g_remote = block;
+          g_hasRemote.store (true, std::memory_order_relaxed);
+        }
+      return;
+    }
+  std::free (p);
+}
+
+} // namespace ns3
@@ -0,0 +1,64 @@
+#ifndef PACKETBUFFERPOOL_H
+#define PACKETBUFFERPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * Size-class pool for the small allocations of a simulation's hot loop.
+ *
+ * ns-3 already recycles Buffer data (BUFFER_FREE_LIST) and PacketMetadata
+ * (its own free list).  The Packet objects, their tags and the events
+ * that carry them use plain new, so packet-pool-operators.cc replaces the
+ * global operator new and delete with Allocate and Free.  That file is
+ * built into a scenario's program only, next to it in its scratch
+ * directory, never into the module: every other program keeps the
+ * system allocator and pays nothing.
+ *
+ * While the pool is enabled, every allocation of up to MaxSize bytes
+ * made on the enabling thread comes from per-size free lists (16 byte
+ * classes), packets or not, which is why the scenarios only enable it
+ * around Simulator::Run.  The lists are carved from 64 KB chunks of one
+ * reserved address range.  A freed block goes back on its class's list
+ * and is reused by the next allocation of that size.  Chunks keep their
+ * size class and are never returned to the system, so blocks freed in
+ * one class can't serve another and peak RSS only grows.  Larger
+ * allocations, and all allocations on other threads, go to malloc.
+ */
+class PacketBufferPool {
+public:
+  static const std::size_t MaxSize = 2048;
+
+  struct Stats
+  {
+    uint64_t allocations;   //!< served from the pool
+    uint64_t reused;        //!< of which recycled blocks
+    uint64_t reservedBytes; //!< chunks carved so far
+    uint64_t fallbacks;     //!< sent to malloc because the range was full
+  };
+
+  /**
+   * Pool the calling thread's allocations from now on.  Aborts unless
+   * packet-pool-operators.cc is built into the program.
+   */
+  static void Enable ();
+
+  /** Stop pooling new allocations.  Pooled blocks can still be freed. */
+  static void Disable ();
+
+  static bool IsEnabled ();
+  static Stats GetStats ();
+  static void PrintStats (std::ostream &os);
+
+  /** Used by the replacement operator new and delete in packet-pool-operators.cc. */
+  static void *Allocate (std::size_t size);
+  static void Free (void *p);
+  static void SetOperatorsInstalled ();
+};
+
+}
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * Global operator new and delete on top of PacketBufferPool, for the
+ * scenarios that take --packetPool.  Build this file into the scenario's
+ * program only, as a second file of its scratch directory:
+ *
+ *   scratch/mywpanB/mywpanB.cc
+ *   scratch/mywpanB/packet-pool-operators.cc
+ *
+ * so that every other program linking the network module keeps the
+ * system allocator.
+ */
+
+#include "ns3/packet-buffer-pool.h"
+#include <new>
+
+namespace {
+
+struct OperatorsInstalled
+{
+  OperatorsInstalled ()
+  {
+    ns3::PacketBufferPool::SetOperatorsInstalled ();
+  }
+} g_operatorsInstalled;
+
+void *
+AllocateOrThrow (std::size_t size)
+{
+  void *p;
+  while ((p = ns3::PacketBufferPool::Allocate (size)) == 0)
+    {
+      std::new_handler handler = std::get_new_handler ();
+      if (handler == 0)
+        {
+          throw std::bad_alloc ();
+        }
+      handler ();
+    }
+  return p;
+}
+
+} // anonymous namespace
+
+void *
+operator new (std::size_t size)
+{
+  return AllocateOrThrow (size);
+}
+
+void *
+operator new[] (std::size_t size)
+{
+  return AllocateOrThrow (size);
+}
+
+void *
+operator new (std::size_t size, const std::nothrow_t &) noexcept
+{
+  return ns3::PacketBufferPool::Allocate (size);
+}
+
+void *
+operator new[] (std::size_t size, const std::nothrow_t &) noexcept
+{
+  return ns3::PacketBufferPool::Allocate (size);
+}
+
+void
+operator delete (void *p) noexcept
+{
+  ns3::PacketBufferPool::Free (p);
+}
+
+void
+operator delete[] (void *p) noexcept
+{
+  ns3::PacketBufferPool::Free (p);
+}
+
+void
+operator delete (void *p, std::size_t) noexcept
+{
+  ns3::PacketBufferPool::Free (p);
+}
+
+void
+operator delete[] (void *p, std::size_t) noexcept
+{
+  ns3::PacketBufferPool::Free (p);
+}
+
+void
+operator delete (void *p, const std::nothrow_t &) noexcept
+{
+  ns3::PacketBufferPool::Free (p);
+}
+
+void
+operator delete[] (void *p, const std::nothrow_t &) noexcept
+{
+  ns3::PacketBufferPool::Free (p);
+}
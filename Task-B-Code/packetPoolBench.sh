@@ -0,0 +1,20 @@
+#!/bin/bash
+
+# Wall time and peak RSS of long, high-rate runs with and without
+# --packetPool. Run from the ns-3 directory after ./waf build, with each
+# scenario in a scratch subdirectory next to packet-pool-operators.cc
+# (scratch/mywpanB/, scratch/wired/).
+
+runs=(
+    "scratch/mywpanB --n_nodes=10 --error_rate=0 --duration=300"
+    "scratch/wired --n_nodes=100 --n_flows=50 --pkts_ps=500 --duration=60"
+)
+
+for run in "${runs[@]}"; do
+    echo "$run"
+    for pool in 0 1; do
+        /usr/bin/time -f "  packetPool=$pool: %e s, %M KB peak RSS" ./waf --run "$run --packetPool=$pool" > /dev/null
+    done
+done
+
+rm -f *.flowstats
@@ -1,8 +1,9 @@
 import xml.etree.ElementTree as ET
 import os
 import pandas as pd
+import numpy as np
 
-df = pd.DataFrame(columns=['Algo', 'Nodes', 'Error Rate', 'Throughput', 'End to End Delay',
+df = pd.DataFrame(columns=['Algo', 'Nodes', 'Error Rate', 'Gateways', 'Throughput', 'End to End Delay',
                            'Delivery Ratio', 'Drop Ratio'])
 
 def process(path):
@@ -36,18 +37,55 @@ def process(path):
 
     return totalThroughPut, e2eDelay, deliveryRatio, dropRatio
 
+# column order of the .flowstats files written by FlowStatsFile::Serialize
+FLOWSTATS_COLUMNS = ['flowId', 'timeFirstTxPacket', 'timeFirstRxPacket', 'timeLastTxPacket',
+                     'timeLastRxPacket', 'delaySum', 'jitterSum', 'lastDelay', 'txBytes',
+                     'rxBytes', 'txPackets', 'rxPackets', 'lostPackets', 'timesForwarded']
+
+def load_flowstats(path):
+    magic = np.fromfile(path, dtype='S8', count=1)[0]
+    if magic != b'NS3FLOWS':
+        raise ValueError(path + " is not a .flowstats file")
+    version, n_columns = np.fromfile(path, dtype='<u4', count=2, offset=8)
+    n_flows = int(np.fromfile(path, dtype='<u8', count=1, offset=16)[0])
+    columns = np.memmap(path, dtype='<i8', mode='r', offset=32, shape=(n_columns, n_flows))
+    return dict(zip(FLOWSTATS_COLUMNS, columns))
+
+def process_flowstats(path):
+    flows = load_flowstats(path)
+    half = (len(flows['flowId'])+1)//2
+    flows = {k: v[:half] for k, v in flows.items()}
+
+    duration = (flows['timeLastRxPacket']-flows['timeFirstRxPacket'])*1e-9
+    valid = (flows['rxPackets'] != 0) & (duration != 0)
+
+    totalThroughPut = np.sum(flows['rxBytes'][valid]*8 / duration[valid])
+    totalPacketsSent = int(np.sum(flows['txPackets'][valid]))
+    totalPacketsReceived = int(np.sum(flows['rxPackets'][valid]))
+    totalDelaySum = float(np.sum(flows['delaySum'][valid]))
+
+    totalThroughPut = round(totalThroughPut/1024, 2)
+    e2eDelay = round((totalDelaySum/totalPacketsReceived)/1000)
+    deliveryRatio = round((totalPacketsReceived / totalPacketsSent)*100, 2)
+    dropRatio = round(((totalPacketsSent-totalPacketsReceived) / totalPacketsSent)*100, 2)
+
+    return totalThroughPut, e2eDelay, deliveryRatio, dropRatio
+
 
 for f in os.listdir():
-    if f.endswith(".flowmonitor"):
+    if f.endswith(".flowmonitor") or f.endswith(".flowstats"):
         l = f.split(".")[0]
         l = l.split("-")
+        # runs with several gateways end in -gwN
+        gateways = int(l.pop()[2:]) if l[-1].startswith("gw") else 1
         algo = l[1].strip()
         nodes = int(l[2].strip())
         error_rate = int(l[3].strip())
         path = os.path.join(os.getcwd(), f)
-        result = process(path)
+        result = process(path) if f.endswith(".flowmonitor") else process_flowstats(path)
 
-        row = {'Algo': algo, 'Nodes': nodes, 'Error Rate': error_rate, 'Throughput': result[0],  
+        row = {'Algo': algo, 'Nodes': nodes, 'Error Rate': error_rate, 'Gateways': gateways,
+               'Throughput': result[0],  
                'End to End Delay': result[1], 'Delivery Ratio': result[2], 
                'Drop Ratio': result[3]}
 
@@ -0,0 +1,326 @@
+#include "flow-stats-file-reader.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+using namespace std;
+using namespace ns3;
+
+/*
+    Native replacement for the processFlow*.py scripts. Reads every
+    .flowmonitor and .flowstats file of a directory in parallel and writes
+    the same results.csv:
+
+        g++ -O3 -march=native -pthread -o processFlows processFlows.cc
+        ./processFlows [--layout=B|wired|wpan|coverage] [--dir=.] [--output=results.csv] [--threads=N]
+
+    The layout picks the file name fields and the rules of the script it
+    replaces; by default it follows the first file's prefix (wpanB-, w-,
+    wpan- with 3 or 4 fields). The B and wpan layouts add a Gateways
+    column, read from the -gwN ending of the name, 1 without one.
+
+    .flowstats columns are summed straight out of the mapped file. XML is
+    scanned in place: only the <Flow> attributes of <FlowStats> are read,
+    into per-thread columns that are reused from file to file.
+*/
+
+struct Layout {
+    string name, prefix;
+    vector<string> fields;   // after the prefix; a field named Algo is kept as text,
+                             // a last one named Gateways comes from the -gwN ending
+    bool skipIdle;           // flows without rx packets or rx time are left out of every sum
+    int throughputDecimals;
+};
+
+const vector<Layout> layouts = {
+    {"B", "wpanB", {"Algo", "Nodes", "Error Rate", "Gateways"}, true, 2},
+    {"wired", "w", {"Nodes", "Flows", "Packets Per Second"}, false, 0},
+    {"wpan", "wpan", {"Nodes", "Flows", "Packets Per Second", "Gateways"}, false, 0},
+    {"coverage", "wpan", {"Nodes", "Flows", "Packets Per Second", "Max Range"}, false, 0},
+};
+
+// the first half of the flows, the data direction, as the scripts
+struct FlowColumns {
+    vector<double> firstRx, lastRx, delaySum, rxBytes, txPackets, rxPackets;
+
+    void clear() {
+        firstRx.clear(); lastRx.clear(); delaySum.clear();
+        rxBytes.clear(); txPackets.clear(); rxPackets.clear();
+    }
+};
+
+struct Metrics {
+    double throughput=0, delaySum=0, txPackets=0, rxPackets=0;
+};
+
+string layoutName, dir=".", output="results.csv";
+uint threads=0;
+const Layout* layout;
+
+vector<string> split(string s, char sep) {
+    vector<string> parts;
+    size_t start=0, end;
+    while( (end=s.find(sep, start))!=string::npos ) {
+        parts.push_back(s.substr(start, end-start));
+        start = end+1;
+    }
+    parts.push_back(s.substr(start));
+    return parts;
+}
+
+bool endsWith(const string& s, const char* suffix) {
+    size_t n = strlen(suffix);
+    return s.size()>=n && s.compare(s.size()-n, n, suffix)==0;
+}
+
+void processArguments(int argc, char** argv) {
+    for( int i=1; i<argc; i++ ) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        string key = arg.substr(0, eq), value = eq==string::npos ? "" : arg.substr(eq+1);
+        if( key=="--layout" ) layoutName = value;
+        else if( key=="--dir" ) dir = value;
+        else if( key=="--output" ) output = value;
+        else if( key=="--threads" ) threads = atoi(value.c_str());
+        else {
+            std::cout << "Unknown Argument " << arg << "\n";
+            exit(0);
+        }
+    }
+    if( threads==0 ) threads = max(1u, thread::hardware_concurrency());
+}
+
+// the sums are plain loops over the columns, which the compiler vectorizes
+template <typename T>
+Metrics sumFlows(const T* firstRx, const T* lastRx, const T* delaySum, const T* rxBytes,
+                 const T* txPackets, const T* rxPackets, size_t n) {
+    double throughput=0, delay=0, tx=0, rx=0;
+    for( size_t i=0; i<n; i++ ) {
+        double duration = (double(lastRx[i]) - double(firstRx[i]))*1e-9;
+        bool keep = !layout->skipIdle || (rxPackets[i]!=0 && duration!=0);
+        // a flow with a single rx packet has no rate
+        bool rated = keep && duration!=0;
+        throughput += rated ? double(rxBytes[i])*8 / (rated ? duration : 1) : 0;
+        delay += keep ? double(delaySum[i]) : 0;
+        tx += keep ? double(txPackets[i]) : 0;
+        rx += keep ? double(rxPackets[i]) : 0;
+    }
+    Metrics m;
+    m.throughput = throughput;
+    m.delaySum = delay;
+    m.txPackets = tx;
+    m.rxPackets = rx;
+    return m;
+}
+
+bool processFlowStats(string path, Metrics& m) {
+    FlowStatsFileReader reader;
+    if( !reader.Open(path) ) return false;
+    size_t half = (reader.GetNFlows()+1)/2;
+    m = sumFlows(reader.GetColumn(TIME_FIRST_RX_PACKET), reader.GetColumn(TIME_LAST_RX_PACKET),
+                 reader.GetColumn(DELAY_SUM), reader.GetColumn(RX_BYTES),
+                 reader.GetColumn(TX_PACKETS), reader.GetColumn(RX_PACKETS), half);
+    return true;
+}
+
+// "+1.00302e+09ns" and "1024" both parse up to the unit
+void parseFlow(const char* p, const char* end, FlowColumns& flows) {
+    double firstRx=0, lastRx=0, delaySum=0, rxBytes=0, txPackets=0, rxPackets=0;
+    while( p<end && *p!='>' ) {
+        const char* eq = (const char*) memchr(p, '=', end-p);
+        if( !eq || eq+1>=end ) break;
+        const char* name = p;
+        while( name<eq && (*name==' ' || *name=='\t' || *name=='\n' || *name=='\r') ) name++;
+        size_t len = eq-name;
+        const char* value = eq+2;
+        const char* close = (const char*) memchr(value, eq[1], end-value);
+        if( !close ) break;
+        double v = strtod(value, 0);
+
+        if( len==17 && memcmp(name, "timeFirstRxPacket", 17)==0 ) firstRx = v;
+        else if( len==16 && memcmp(name, "timeLastRxPacket", 16)==0 ) lastRx = v;
+        else if( len==8 && memcmp(name, "delaySum", 8)==0 ) delaySum = v;
+        else if( len==7 && memcmp(name, "rxBytes", 7)==0 ) rxBytes = v;
+        else if( len==9 && memcmp(name, "txPackets", 9)==0 ) txPackets = v;
+        else if( len==9 && memcmp(name, "rxPackets", 9)==0 ) rxPackets = v;
+        p = close+1;
+    }
+    flows.firstRx.push_back(firstRx);
+    flows.lastRx.push_back(lastRx);
+    flows.delaySum.push_back(delaySum);
+    flows.rxBytes.push_back(rxBytes);
+    flows.txPackets.push_back(txPackets);
+    flows.rxPackets.push_back(rxPackets);
+}
+
+bool processXml(string path, FlowColumns& flows, Metrics& m) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if( fd<0 ) return false;
+    struct stat st;
+    if( fstat(fd, &st)!=0 || st.st_size==0 ) {
+        close(fd);
+        return false;
+    }
+    void* data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if( data==MAP_FAILED ) return false;
+    const char* begin = (const char*) data;
+    const char* end = begin + st.st_size;
+
+    // Ipv4FlowClassifier has <Flow> elements too: stop at </FlowStats>
+    const char* p = (const char*) memmem(begin, end-begin, "<FlowStats>", 11);
+    const char* stop = p ? (const char*) memmem(p, end-p, "</FlowStats>", 12) : 0;
+    if( !stop ) {
+        munmap(data, st.st_size);
+        return false;
+    }
+
+    flows.clear();
+    while( (p=(const char*) memmem(p, stop-p, "<Flow ", 6))!=0 ) {
+        p += 6;
+        parseFlow(p, stop, flows);
+    }
+    munmap(data, st.st_size);
+
+    size_t half = (flows.firstRx.size()+1)/2;
+    m = sumFlows(flows.firstRx.data(), flows.lastRx.data(), flows.delaySum.data(), flows.rxBytes.data(),
+                 flows.txPackets.data(), flows.rxPackets.data(), half);
+    return true;
+}
+
+// as Python prints round(x, decimals)
+string formatRounded(double x, int decimals) {
+    if( !std::isfinite(x) ) return x>0 ? "inf" : "nan";
+    char buf[64];
+    snprintf(buf, sizeof buf, "%.*f", decimals, x);
+    string s = buf;
+    if( decimals>0 ) {
+        while( s.back()=='0' && s[s.size()-2]!='.' ) s.pop_back();
+    }
+    return s;
+}
+
+// the name split at '-', with the gateway count of a -gwN ending taken off
+vector<string> nameParts(const string& file, string& gateways) {
+    vector<string> parts = split(split(file, '.')[0], '-');
+    gateways = "1";
+    if( parts.size()>1 && parts.back().compare(0, 2, "gw")==0 ) {
+        gateways = parts.back().substr(2);
+        parts.pop_back();
+    }
+    return parts;
+}
+
+// the fields taken from the name itself
+uint positionalFields(const Layout& l) {
+    return l.fields.size() - (!l.fields.empty() && l.fields.back()=="Gateways");
+}
+
+string formatRow(const string& file, const Metrics& m) {
+    string gateways;
+    vector<string> parts = nameParts(file, gateways);
+    string row;
+    for( uint i=0; i<layout->fields.size(); i++ ) {
+        string field = i>=positionalFields(*layout) ? gateways : i+1<parts.size() ? parts[i+1] : "";
+        if( layout->fields[i]!="Algo" ) field = to_string(atol(field.c_str()));
+        row += field + ",";
+    }
+
+    double sent = m.txPackets, received = m.rxPackets;
+    row += formatRounded(m.throughput/1024, layout->throughputDecimals) + ",";
+    row += (received==0 ? string("inf") : formatRounded(m.delaySum/received/1000, 0)) + ",";
+    row += formatRounded(received/sent*100, 2) + ",";
+    row += formatRounded((sent-received)/sent*100, 2);
+    return row;
+}
+
+const Layout* detectLayout(const string& file) {
+    string gateways;
+    vector<string> parts = nameParts(file, gateways);
+    for( const Layout& l : layouts ) {
+        if( l.prefix==parts[0] && positionalFields(l)==parts.size()-1 ) return &l;
+    }
+    return 0;
+}
+
+int main (int argc, char** argv) {
+    processArguments(argc, argv);
+
+    vector<string> files;
+    DIR* d = opendir(dir.c_str());
+    if( !d ) {
+        std::cout << "Can't Open Directory " << dir << "\n";
+        return 1;
+    }
+    while( dirent* entry = readdir(d) ) {
+        string name = entry->d_name;
+        if( endsWith(name, ".flowmonitor") || endsWith(name, ".flowstats") ) files.push_back(name);
+    }
+    closedir(d);
+    sort(files.begin(), files.end());
+    if( files.empty() ) {
+        std::cout << "No FlowMonitor Files In " << dir << "\n";
+        return 0;
+    }
+
+    if( layoutName=="" ) {
+        layout = detectLayout(files[0]);
+        if( !layout ) {
+            std::cout << "Unknown File Layout " << files[0] << ", Pass --layout\n";
+            return 1;
+        }
+    }
+    else {
+        for( const Layout& l : layouts ) if( l.name==layoutName ) layout = &l;
+        if( !layout ) {
+            std::cout << "Unknown Layout " << layoutName << "\n";
+            return 1;
+        }
+    }
+
+    vector<string> rows (files.size());
+    vector<char> failed (files.size(), 0);
+    atomic<size_t> next (0);
+    auto worker = [&]() {
+        FlowColumns flows;
+        size_t i;
+        while( (i=next++)<files.size() ) {
+            string path = dir + "/" + files[i];
+            Metrics m;
+            bool ok = endsWith(files[i], ".flowstats") ? processFlowStats(path, m) : processXml(path, flows, m);
+            if( ok ) rows[i] = formatRow(files[i], m);
+            else failed[i] = 1;
+        }
+    };
+    vector<thread> pool;
+    for( uint t=1; t<min<size_t>(threads, files.size()); t++ ) pool.emplace_back(worker);
+    worker();
+    for( thread& t : pool ) t.join();
+
+    FILE* out = fopen(output.c_str(), "w");
+    if( !out ) {
+        std::cout << "Can't Write " << output << "\n";
+        return 1;
+    }
+    for( const string& field : layout->fields ) fprintf(out, "%s,", field.c_str());
+    fprintf(out, "Throughput,End to End Delay,Delivery Ratio,Drop Ratio\n");
+    uint nFailed = 0;
+    for( size_t i=0; i<files.size(); i++ ) {
+        if( failed[i] ) {
+            std::cout << "Skipped " << files[i] << ": Not A FlowMonitor File\n";
+            nFailed++;
+        }
+        else fprintf(out, "%s\n", rows[i].c_str());
+    }
+    fclose(out);
+
+    std::cout << files.size()-nFailed << " Runs Written To " << output << "\n";
+    return 0;
+}
@@ -0,0 +1,232 @@
+#include "profiling-simulator-impl.h"
+#include "ns3/log.h"
+#include "ns3/event-impl.h"
+#include "ns3/simulator.h"
+#include <algorithm>
+#include <cxxabi.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <typeinfo>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ProfilingSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (ProfilingSimulatorImpl);
+
+/**
+ * Runs the wrapped event and charges its wall time to its source.  The
+ * wrapper is what the queue and the EventId hold, so cancelling the
+ * EventId cancels the wrapper and the wrapped event is never invoked.
+ */
+class ProfiledEvent : public EventImpl
+{
+public:
+  ProfiledEvent (EventImpl *event, ProfilingSimulatorImpl::SourceStats *stats)
+    : m_event (event),
+      m_stats (stats)
+  {
+  }
+
+  virtual ~ProfiledEvent ()
+  {
+    // the reference the scheduler would have dropped after running it
+    m_event->Unref ();
+  }
+
+protected:
+  virtual void Notify (void)
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+    m_event->Invoke ();
+    m_stats->wallTime += std::chrono::steady_clock::now () - start;
+    m_stats->executed++;
+  }
+
+private:
+  EventImpl *m_event;
+  ProfilingSimulatorImpl::SourceStats *m_stats;
+};
+
+// the end of the bracketed list starting at name[start], or npos
+static std::string::size_type
+SkipBrackets (const std::string &name, std::string::size_type start)
+{
+  int depth = 0;
+  for (std::string::size_type i = start; i < name.size (); i++)
+    {
+      if (name[i] == '<' || name[i] == '(')
+        {
+          depth++;
+        }
+      else if ((name[i] == '>' || name[i] == ')') && --depth == 0)
+        {
+          return i + 1;
+        }
+    }
+  return std::string::npos;
+}
+
+/*
+ * The scheduled function's type, i.e. MakeEvent's first parameter, out of
+ * the name of the EventImpl class MakeEvent defines, as in
+ * "ns3::MakeEvent<...>(void (ns3::LrWpanCsmaCa::*)(), ...)::EventMemberImpl0".
+ */
+static std::string
+SourceName (const std::type_index &type)
+{
+  int status;
+  char *demangled = abi::__cxa_demangle (type.name (), 0, 0, &status);
+  std::string name = status == 0 ? demangled : type.name ();
+  std::free (demangled);
+
+  std::string::size_type start = name.find ("MakeEvent<");
+  if (start == std::string::npos)
+    {
+      return name;
+    }
+  std::string::size_type params = SkipBrackets (name, start + 9);
+  if (params == std::string::npos || name[params] != '(')
+    {
+      return name;
+    }
+  int depth = 0;
+  for (std::string::size_type i = params + 1; i < name.size (); i++)
+    {
+      if (name[i] == '<' || name[i] == '(')
+        {
+          depth++;
+        }
+      else if (depth > 0 && (name[i] == '>' || name[i] == ')'))
+        {
+          depth--;
+        }
+      else if (depth == 0 && (name[i] == ',' || name[i] == ')'))
+        {
+          return name.substr (params + 1, i - params - 1);
+        }
+    }
+  return name;
+}
+
+TypeId
+ProfilingSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ProfilingSimulatorImpl")
+    .SetParent<DefaultSimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<ProfilingSimulatorImpl> ()
+  ;
+  return tid;
+}
+
+ProfilingSimulatorImpl::ProfilingSimulatorImpl ()
+  : m_scheduled (0),
+    m_removed (0),
+    m_highWaterMark (0),
+    m_start (std::chrono::steady_clock::now ())
+{
+  NS_LOG_FUNCTION (this);
+}
+
+EventImpl *
+ProfilingSimulatorImpl::Wrap (EventImpl *event)
+{
+  SourceStats *stats = &m_sources[std::type_index (typeid (*event))];
+  stats->scheduled++;
+
+  // everything scheduled and not yet popped or removed, cancelled events included
+  m_scheduled++;
+  uint64_t queued = m_scheduled - GetEventCount () - m_removed;
+  m_highWaterMark = std::max (m_highWaterMark, queued);
+
+  return new ProfiledEvent (event, stats);
+}
+
+EventId
+ProfilingSimulatorImpl::Schedule (const Time &delay, EventImpl *event)
+{
+  return DefaultSimulatorImpl::Schedule (delay, Wrap (event));
+}
+
+void
+ProfilingSimulatorImpl::ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event)
+{
+  DefaultSimulatorImpl::ScheduleWithContext (context, delay, Wrap (event));
+}
+
+EventId
+ProfilingSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return DefaultSimulatorImpl::ScheduleNow (Wrap (event));
+}
+
+void
+ProfilingSimulatorImpl::Remove (const EventId &id)
+{
+  // as DefaultSimulatorImpl::Remove, which ignores expired events
+  if (id.GetUid () != EventId::UID::DESTROY && !IsExpired (id))
+    {
+      m_removed++;
+    }
+  DefaultSimulatorImpl::Remove (id);
+}
+
+void
+ProfilingSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  PrintReport (std::cout);
+  DefaultSimulatorImpl::Destroy ();
+}
+
+void
+ProfilingSimulatorImpl::PrintReport (std::ostream &os) const
+{
+  typedef std::pair<std::string, SourceStats> Source;
+  std::vector<Source> sources;
+  uint64_t executed = 0;
+  std::chrono::steady_clock::duration eventTime {0};
+  for (const auto &it : m_sources)
+    {
+      sources.push_back (Source (SourceName (it.first), it.second));
+      executed += it.second.executed;
+      eventTime += it.second.wallTime;
+    }
+  std::sort (sources.begin (), sources.end (), [] (const Source &a, const Source &b)
+             { return a.second.wallTime > b.second.wallTime; });
+
+  double wall = std::chrono::duration<double> (std::chrono::steady_clock::now () - m_start).count ();
+  double inEvents = std::chrono::duration<double> (eventTime).count ();
+  double simulated = Now ().GetSeconds ();
+
+  os << "\n--------------------------------------------------------------------------\n";
+  os << "Event Profile: " << executed << " executed, "
+     << GetEventCount () - executed << " cancelled, "
+     << m_scheduled - GetEventCount () - m_removed << " still queued, "
+     << m_removed << " removed\n";
+  os << "Simulated " << simulated << " s in " << wall << " s wall ("
+     << inEvents << " s in events), "
+     << (simulated > 0 ? executed / simulated : 0) << " events/simulated s, "
+     << (wall > 0 ? executed / wall : 0) << " events/wall s\n";
+  os << "Event Queue High-Water Mark: " << m_highWaterMark << "\n";
+  os << "--------------------------------------------------------------------------\n";
+  os << std::setw (7) << "wall %" << std::setw (11) << "wall ms" << std::setw (10) << "ns/event"
+     << std::setw (12) << "executed" << std::setw (12) << "scheduled" << "  source\n";
+  for (const Source &source : sources)
+    {
+      double ms = std::chrono::duration<double, std::milli> (source.second.wallTime).count ();
+      os << std::fixed << std::setprecision (1)
+         << std::setw (7) << (inEvents > 0 ? ms / 10 / inEvents : 0)
+         << std::setw (11) << ms
+         << std::setw (10) << (source.second.executed ? ms * 1e6 / source.second.executed : 0)
+         << std::setw (12) << source.second.executed
+         << std::setw (12) << source.second.scheduled
+         << "  " << source.first << "\n";
+    }
+  os << std::defaultfloat;
+}
+
+} // namespace ns3
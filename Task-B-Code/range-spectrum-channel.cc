@@ -0,0 +1,269 @@
+#include "range-spectrum-channel.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+#include "ns3/antenna-model.h"
+#include "ns3/angles.h"
+#include "ns3/spectrum-propagation-loss-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RangeSpectrumChannel");
+NS_OBJECT_ENSURE_REGISTERED (RangeSpectrumChannel);
+
+TypeId
+RangeSpectrumChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RangeSpectrumChannel")
+    .SetParent<SpectrumChannel> ()
+    .SetGroupName ("Spectrum")
+    .AddConstructor<RangeSpectrumChannel> ()
+    .AddAttribute ("MaxRange",
+                   "Maximum transmission range (m), normally the RangePropagationLossModel's",
+                   DoubleValue (3),
+                   MakeDoubleAccessor (&RangeSpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (1e-3, 1e6))
+  ;
+  return tid;
+}
+
+RangeSpectrumChannel::RangeSpectrumChannel ()
+  : m_maxRange (3),
+    m_gridValid (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+RangeSpectrumChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (Ptr<MobilityModel> mobility : m_connected)
+    {
+      mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                               MakeCallback (&RangeSpectrumChannel::CourseChanged, this));
+    }
+  m_connected.clear ();
+  m_phyList.clear ();
+  m_grid.clear ();
+  m_spectrumModel = 0;
+  SpectrumChannel::DoDispose ();
+}
+
+void
+RangeSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  m_phyList.push_back (phy);
+  m_gridValid = false;
+}
+
+void
+RangeSpectrumChannel::RemoveRx (Ptr<SpectrumPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  std::vector<Ptr<SpectrumPhy> >::iterator it = std::find (m_phyList.begin (), m_phyList.end (), phy);
+  if (it != m_phyList.end ())
+    {
+      m_phyList.erase (it);
+      m_gridValid = false;
+    }
+}
+
+void
+RangeSpectrumChannel::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  m_gridValid = false;
+}
+
+uint64_t
+RangeSpectrumChannel::GetCellKey (int64_t x, int64_t y, int64_t z) const
+{
+  // 21 bits per axis
+  const int64_t offset = 1 << 20;
+  return (static_cast<uint64_t> (x + offset) & 0x1fffff) << 42
+         | (static_cast<uint64_t> (y + offset) & 0x1fffff) << 21
+         | (static_cast<uint64_t> (z + offset) & 0x1fffff);
+}
+
+void
+RangeSpectrumChannel::BuildGrid ()
+{
+  NS_LOG_FUNCTION (this);
+  m_grid.clear ();
+  m_unplaced.clear ();
+  for (uint32_t i = 0; i < m_phyList.size (); i++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[i]->GetMobility ();
+      if (mobility == 0)
+        {
+          m_unplaced.push_back (i);
+          continue;
+        }
+      if (std::find (m_connected.begin (), m_connected.end (), mobility) == m_connected.end ())
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange",
+                                                MakeCallback (&RangeSpectrumChannel::CourseChanged, this));
+          m_connected.push_back (mobility);
+        }
+      Vector p = mobility->GetPosition ();
+      m_grid[GetCellKey (std::floor (p.x / m_maxRange), std::floor (p.y / m_maxRange),
+                         std::floor (p.z / m_maxRange))].push_back (i);
+    }
+  m_gridValid = true;
+  NS_LOG_INFO (m_phyList.size () << " PHYs in " << m_grid.size () << " cells");
+}
+
+void
+RangeSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
+{
+  NS_LOG_FUNCTION (this << txParams);
+  NS_ASSERT_MSG (txParams->psd, "NULL txPsd");
+  NS_ASSERT_MSG (txParams->txPhy, "NULL txPhy");
+
+  Ptr<SpectrumSignalParameters> txParamsTrace = txParams->Copy ();
+  m_txSigsTrace (txParamsTrace);
+
+  if (m_spectrumModel == 0)
+    {
+      m_spectrumModel = txParams->psd->GetSpectrumModel ();
+    }
+  else
+    {
+      NS_ASSERT (*(txParams->psd->GetSpectrumModel ()) == *m_spectrumModel);
+    }
+
+  if (!m_gridValid)
+    {
+      BuildGrid ();
+    }
+
+  Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
+
+  std::vector<uint32_t> candidates (m_unplaced);
+  if (senderMobility)
+    {
+      Vector p = senderMobility->GetPosition ();
+      int64_t cx = std::floor (p.x / m_maxRange);
+      int64_t cy = std::floor (p.y / m_maxRange);
+      int64_t cz = std::floor (p.z / m_maxRange);
+      for (int64_t dx = -1; dx <= 1; dx++)
+        for (int64_t dy = -1; dy <= 1; dy++)
+          for (int64_t dz = -1; dz <= 1; dz++)
+            {
+              std::unordered_map<uint64_t, std::vector<uint32_t> >::const_iterator cell =
+                m_grid.find (GetCellKey (cx + dx, cy + dy, cz + dz));
+              if (cell != m_grid.end ())
+                {
+                  candidates.insert (candidates.end (), cell->second.begin (), cell->second.end ());
+                }
+            }
+      std::sort (candidates.begin (), candidates.end ());
+    }
+  else
+    {
+      // without a position the sender can't be located in the grid
+      candidates.resize (m_phyList.size ());
+      for (uint32_t i = 0; i < m_phyList.size (); i++)
+        {
+          candidates[i] = i;
+        }
+    }
+
+  for (uint32_t index : candidates)
+    {
+      Ptr<SpectrumPhy> rxPhy = m_phyList[index];
+      if (rxPhy == txParams->txPhy)
+        {
+          continue;
+        }
+
+      Time delay = MicroSeconds (0);
+      Ptr<MobilityModel> receiverMobility = rxPhy->GetMobility ();
+      Ptr<SpectrumSignalParameters> rxParams;
+
+      if (senderMobility && receiverMobility)
+        {
+          if (senderMobility->GetDistanceFrom (receiverMobility) > m_maxRange)
+            {
+              continue;
+            }
+
+          rxParams = txParams->Copy ();
+          double pathLossDb = 0;
+          if (rxParams->txAntenna != 0)
+            {
+              Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
+              pathLossDb -= rxParams->txAntenna->GetGainDb (txAngles);
+            }
+          Ptr<AntennaModel> rxAntenna = rxPhy->GetRxAntenna ();
+          if (rxAntenna != 0)
+            {
+              Angles rxAngles (senderMobility->GetPosition (), receiverMobility->GetPosition ());
+              pathLossDb -= rxAntenna->GetGainDb (rxAngles);
+            }
+          if (m_propagationLoss)
+            {
+              pathLossDb -= m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
+            }
+          if (pathLossDb > m_maxLossDb)
+            {
+              continue;
+            }
+          *(rxParams->psd) *= std::pow (10.0, (-pathLossDb) / 10.0);
+
+          if (m_spectrumPropagationLoss)
+            {
+              rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd,
+                                                                                     senderMobility,
+                                                                                     receiverMobility);
+            }
+          if (m_propagationDelay)
+            {
+              delay = m_propagationDelay->GetDelay (senderMobility, receiverMobility);
+            }
+        }
+      else
+        {
+          rxParams = txParams->Copy ();
+        }
+
+      Ptr<NetDevice> netDev = rxPhy->GetDevice ();
+      if (netDev)
+        {
+          Simulator::ScheduleWithContext (netDev->GetNode ()->GetId (), delay,
+                                          &RangeSpectrumChannel::StartRx, this, rxParams, rxPhy);
+        }
+      else
+        {
+          Simulator::Schedule (delay, &RangeSpectrumChannel::StartRx, this, rxParams, rxPhy);
+        }
+    }
+}
+
+void
+RangeSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
+{
+  NS_LOG_FUNCTION (this << params);
+  receiver->StartRx (params);
+}
+
+std::size_t
+RangeSpectrumChannel::GetNDevices (void) const
+{
+  return m_phyList.size ();
+}
+
+Ptr<NetDevice>
+RangeSpectrumChannel::GetDevice (std::size_t i) const
+{
+  return m_phyList.at (i)->GetDevice ()->GetObject<NetDevice> ();
+}
+
+} // namespace ns3
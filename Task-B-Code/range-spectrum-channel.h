@@ -0,0 +1,61 @@
+#ifndef RANGESPECTRUMCHANNEL_H
+#define RANGESPECTRUMCHANNEL_H
+
+#include "ns3/spectrum-channel.h"
+#include "ns3/spectrum-phy.h"
+#include "ns3/mobility-model.h"
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * A SingleModelSpectrumChannel for range limited propagation.
+ *
+ * Receivers are indexed in a uniform grid of MaxRange sized cells.  A
+ * transmission only reaches the PHYs in the 27 cells around the sender
+ * that are within MaxRange, so its cost depends on the local density
+ * instead of the total number of PHYs.  With a RangePropagationLossModel
+ * of the same MaxRange, the PHYs it skips are exactly the ones that would
+ * have received the signal at -1000 dBm.
+ *
+ * Receptions are scheduled in AddRx order, as SingleModelSpectrumChannel
+ * schedules them.  The grid is rebuilt lazily after AddRx, RemoveRx or a
+ * CourseChange of any receiver.  PHYs without a mobility model are always
+ * reached.
+ */
+class RangeSpectrumChannel : public SpectrumChannel {
+public:
+  static TypeId GetTypeId (void);
+
+  RangeSpectrumChannel ();
+
+  virtual void AddRx (Ptr<SpectrumPhy> phy);
+  virtual void RemoveRx (Ptr<SpectrumPhy> phy);
+  virtual void StartTx (Ptr<SpectrumSignalParameters> params);
+
+  virtual std::size_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
+
+protected:
+  void DoDispose (void);
+
+private:
+  void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
+  void BuildGrid ();
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+  uint64_t GetCellKey (int64_t x, int64_t y, int64_t z) const;
+
+  std::vector<Ptr<SpectrumPhy> > m_phyList;
+  Ptr<const SpectrumModel> m_spectrumModel;
+  double m_maxRange;
+
+  bool m_gridValid;
+  std::unordered_map<uint64_t, std::vector<uint32_t> > m_grid;   //!< cell -> PHY indices, ascending
+  std::vector<uint32_t> m_unplaced;                              //!< PHYs without a mobility model
+  std::vector<Ptr<MobilityModel> > m_connected;                  //!< CourseChange already hooked
+};
+
+}
+
+#endif
@@ -0,0 +1,592 @@
+#include "sweep-runner.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/fatal-error.h"
+#include "ns3/config.h"
+#include "ns3/names.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SweepRunner");
+
+int SweepRunner::s_reportFd = -1;
+bool SweepRunner::s_replicating = false;
+uint32_t SweepRunner::s_workerJobs = 0;
+
+static std::vector<std::string>
+Split (std::string s, char sep)
+{
+  std::vector<std::string> parts;
+  std::istringstream is (s);
+  std::string part;
+  while (std::getline (is, part, sep))
+    {
+      if (!part.empty ())
+        {
+          parts.push_back (part);
+        }
+    }
+  return parts;
+}
+
+// two-sided 95% quantiles of Student's t, by degrees of freedom
+static double
+StudentT95 (uint32_t df)
+{
+  static const double t[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+  };
+  if (df == 0)
+    {
+      return INFINITY;
+    }
+  // within 0.1% of the exact quantile beyond the table
+  return df <= 30 ? t[df - 1] : 1.96 + 2.4 / df;
+}
+
+// mean and 95% confidence interval half width
+static std::pair<double, double>
+MeanCi (const std::vector<double> &samples)
+{
+  double n = samples.size (), sum = 0, squares = 0;
+  for (double x : samples)
+    {
+      sum += x;
+    }
+  double mean = sum / n;
+  for (double x : samples)
+    {
+      squares += (x - mean) * (x - mean);
+    }
+  return std::make_pair (mean, n > 1 ? StudentT95 (n - 1) * std::sqrt (squares / (n - 1) / n) : INFINITY);
+}
+
+SweepRunner::SweepRunner ()
+  : m_jobs (s_workerJobs ? s_workerJobs : sysconf (_SC_NPROCESSORS_ONLN)),
+    m_batch (1),
+    m_minReplications (1),
+    m_maxReplications (1),
+    m_ciTarget (0.05)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+SweepRunner::Parse (int argc, char** argv)
+{
+  NS_LOG_FUNCTION (this << argc);
+
+  bool sweep = false;
+  int32_t minReplications = -1;
+  uint32_t maxReplications = m_maxReplications;
+  double ciTarget = m_ciTarget;
+  m_baseArgs.clear ();
+  for (int i = 0; i < argc; i++)
+    {
+      std::string arg = argv[i];
+      if (arg.compare (0, 8, "--sweep=") == 0)
+        {
+          AddAxes (arg.substr (8));
+          sweep = true;
+        }
+      else if (arg.compare (0, 7, "--jobs=") == 0)
+        {
+          SetJobs (std::stoul (arg.substr (7)));
+        }
+      else if (arg.compare (0, 8, "--batch=") == 0)
+        {
+          SetBatch (std::stoul (arg.substr (8)));
+        }
+      else if (arg.compare (0, 15, "--replications=") == 0)
+        {
+          maxReplications = std::stoul (arg.substr (15));
+        }
+      else if (arg.compare (0, 18, "--minReplications=") == 0)
+        {
+          minReplications = std::stoul (arg.substr (18));
+        }
+      else if (arg.compare (0, 11, "--ciTarget=") == 0)
+        {
+          ciTarget = std::stod (arg.substr (11));
+        }
+      else if (arg.compare (0, 17, "--replicationCsv=") == 0)
+        {
+          SetReplicationCsv (arg.substr (17));
+        }
+      else
+        {
+          m_baseArgs.push_back (arg);
+        }
+    }
+  if (minReplications < 0)
+    {
+      minReplications = std::min<uint32_t> (3, maxReplications);
+    }
+  SetReplications (minReplications, maxReplications, ciTarget);
+  return sweep || m_maxReplications > 1;
+}
+
+void
+SweepRunner::AddAxis (std::string name, std::vector<std::string> values)
+{
+  NS_LOG_FUNCTION (this << name << values.size ());
+  NS_ABORT_MSG_IF (values.empty (), "Sweep axis " << name << " has no values");
+  m_names.push_back (name);
+  m_values.push_back (values);
+}
+
+void
+SweepRunner::AddAxes (std::string spec)
+{
+  for (std::string axis : Split (spec, ';'))
+    {
+      std::string::size_type eq = axis.find ('=');
+      if (eq == std::string::npos)
+        {
+          NS_FATAL_ERROR ("Sweep axis \"" << axis << "\" is not name=v1,v2,...");
+        }
+      AddAxis (axis.substr (0, eq), Split (axis.substr (eq + 1), ','));
+    }
+}
+
+void
+SweepRunner::SetBaseArgs (int argc, char** argv)
+{
+  m_baseArgs.assign (argv, argv + argc);
+}
+
+void
+SweepRunner::SetJobs (uint32_t jobs)
+{
+  m_jobs = std::max<uint32_t> (1, jobs);
+}
+
+void
+SweepRunner::SetBatch (uint32_t runs)
+{
+  m_batch = std::max<uint32_t> (1, runs);
+}
+
+uint32_t
+SweepRunner::GetBatch () const
+{
+  return m_batch;
+}
+
+void
+SweepRunner::SetReplications (uint32_t min, uint32_t max, double ciTarget)
+{
+  NS_LOG_FUNCTION (this << min << max << ciTarget);
+  NS_ABORT_MSG_IF (max < 1 || min > max, "Replications need 1 <= min <= max, not " << min << " and " << max);
+  m_minReplications = std::max<uint32_t> (1, min);
+  m_maxReplications = max;
+  m_ciTarget = ciTarget;
+}
+
+void
+SweepRunner::SetReplicationCsv (std::string fileName)
+{
+  m_replicationCsv = fileName;
+}
+
+bool
+SweepRunner::IsReplicating ()
+{
+  return s_replicating;
+}
+
+void
+SweepRunner::Report (std::vector<std::pair<std::string, double> > metrics)
+{
+  if (!s_replicating)
+    {
+      return;
+    }
+  std::ostringstream os;
+  os.precision (17);
+  for (const std::pair<std::string, double> &metric : metrics)
+    {
+      NS_ABORT_MSG_IF (metric.first.find_first_of (" \n") != std::string::npos,
+                       "Metric name \"" << metric.first << "\" has white space");
+      os << metric.first << " " << metric.second << "\n";
+    }
+  std::string report = os.str ();
+  if (write (s_reportFd, report.data (), report.size ()) != (ssize_t) report.size ())
+    {
+      NS_FATAL_ERROR ("Can't report metrics to the sweep runner");
+    }
+}
+
+uint32_t
+SweepRunner::GetNPoints () const
+{
+  uint32_t n = 1;
+  for (const std::vector<std::string> &values : m_values)
+    {
+      n *= values.size ();
+    }
+  return n;
+}
+
+std::vector<std::string>
+SweepRunner::GetPointArgs (uint32_t point) const
+{
+  // The last axis varies fastest, like the nested loops of the scripts.
+  std::vector<std::string> args (m_names.size ());
+  for (int i = m_names.size () - 1; i >= 0; i--)
+    {
+      args[i] = "--" + m_names[i] + "=" + m_values[i][point % m_values[i].size ()];
+      point /= m_values[i].size ();
+    }
+  return args;
+}
+
+void
+SweepRunner::RunPoint (const Task &task, Callback<void, int, char**> run)
+{
+  std::vector<std::string> args = m_baseArgs;
+  for (std::string arg : GetPointArgs (task.point))
+    {
+      args.push_back (arg);
+    }
+  if (m_maxReplications > 1)
+    {
+      args.push_back ("--RngRun=" + std::to_string (task.replication + 1));
+    }
+
+  std::vector<char*> argv;
+  for (std::string &arg : args)
+    {
+      argv.push_back (&arg[0]);
+    }
+  argv.push_back (0);
+
+  run (args.size (), argv.data ());
+}
+
+void
+SweepRunner::RunBatch (const std::vector<Task> &tasks, int reportFd, Callback<void, int, char**> run)
+{
+  // also keeps a nested runner's workers from reporting into this pipe
+  s_reportFd = reportFd;
+  s_replicating = m_maxReplications > 1;
+
+  for (uint32_t i = 0; i < tasks.size (); i++)
+    {
+      if (i > 0)
+        {
+          // what a fork would have started the run from
+          Simulator::Destroy ();
+          Config::Reset ();
+          Names::Clear ();
+          RngSeedManager::ResetNextStreamIndex ();
+        }
+      RunPoint (tasks[i], run);
+      if (write (reportFd, "done\n", 5) != 5)
+        {
+          NS_FATAL_ERROR ("Can't report a finished run to the sweep runner");
+        }
+    }
+
+  std::cout.flush ();
+  std::fflush (0);
+  _exit (0);
+}
+
+int32_t
+SweepRunner::GetNextPoint (const std::vector<PointResults> &results) const
+{
+  // every point's first replications come first
+  for (uint32_t point = 0; point < results.size (); point++)
+    {
+      if (results[point].started < m_minReplications)
+        {
+          return point;
+        }
+    }
+  // then, once a point's first runs are in and miss the target, more of
+  // them on every idle worker, the point with the fewest in flight first.
+  // Runs started before the point converges overshoot it.
+  int32_t next = -1;
+  for (uint32_t point = 0; point < results.size (); point++)
+    {
+      const PointResults &r = results[point];
+      if (r.started - r.running >= m_minReplications && r.started < m_maxReplications && !IsConverged (r)
+          && (next < 0 || r.running < results[next].running))
+        {
+          next = point;
+        }
+    }
+  return next;
+}
+
+bool
+SweepRunner::IsConverged (const PointResults &results) const
+{
+  // a point without reported metrics has nothing to be converged on
+  if (results.samples.empty ())
+    {
+      return false;
+    }
+  for (const std::vector<double> &samples : results.samples)
+    {
+      if (samples.size () < 2)
+        {
+          return false;
+        }
+      std::pair<double, double> meanCi = MeanCi (samples);
+      if (!std::isfinite (meanCi.first) || !(meanCi.second <= m_ciTarget * std::fabs (meanCi.first)))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+uint32_t
+SweepRunner::ReadReport (int fd, const std::vector<Task> &tasks, std::vector<PointResults> &results) const
+{
+  std::string report;
+  char buffer[4096];
+  ssize_t n;
+  while ((n = read (fd, buffer, sizeof (buffer))) > 0)
+    {
+      report.append (buffer, n);
+    }
+
+  // each finished run's metrics end with a "done" line
+  uint32_t done = 0;
+  std::string::size_type start = 0, end;
+  while (done < tasks.size () && (end = report.find ("done\n", start)) != std::string::npos)
+    {
+      ParseMetrics (report.substr (start, end - start), results[tasks[done].point]);
+      start = end + 5;
+      done++;
+    }
+  return done;
+}
+
+void
+SweepRunner::ParseMetrics (std::string report, PointResults &results) const
+{
+  std::istringstream is (report);
+  std::string name;
+  double value;
+  for (uint32_t i = 0; is >> name >> value; i++)
+    {
+      if (i == results.names.size ())
+        {
+          results.names.push_back (name);
+          results.samples.push_back (std::vector<double> ());
+        }
+      NS_ABORT_MSG_IF (results.names[i] != name, "Replications reported " << results.names[i]
+                       << " and " << name << " as metric " << i);
+      results.samples[i].push_back (value);
+    }
+}
+
+void
+SweepRunner::PrintReplications (const std::vector<PointResults> &results) const
+{
+  std::ofstream csv;
+  if (!m_replicationCsv.empty ())
+    {
+      csv.open (m_replicationCsv, std::ios::app);
+      if (!csv)
+        {
+          NS_FATAL_ERROR ("Can't open file " << m_replicationCsv);
+        }
+    }
+
+  for (uint32_t point = 0; point < results.size (); point++)
+    {
+      const PointResults &r = results[point];
+      std::ostringstream args;
+      for (std::string arg : GetPointArgs (point))
+        {
+          args << (args.tellp () ? " " : "") << arg;
+        }
+      uint32_t n = r.samples.empty () ? 0 : r.samples[0].size ();
+
+      std::cout << "Replications:" << (args.tellp () ? " " : "") << args.str () << ": " << n << " runs";
+      for (uint32_t i = 0; i < r.names.size (); i++)
+        {
+          std::pair<double, double> meanCi = MeanCi (r.samples[i]);
+          std::cout << ", " << r.names[i] << " " << meanCi.first << " +- " << meanCi.second;
+        }
+      std::cout << (IsConverged (r) ? "\n" : " (CI target not reached)\n");
+
+      if (csv.is_open ())
+        {
+          if (csv.tellp () == 0)
+            {
+              csv << "Point,Replications";
+              for (std::string name : r.names)
+                {
+                  csv << "," << name << "," << name << " CI";
+                }
+              csv << "\n";
+            }
+          csv << args.str () << "," << n;
+          for (const std::vector<double> &samples : r.samples)
+            {
+              std::pair<double, double> meanCi = MeanCi (samples);
+              csv << "," << meanCi.first << "," << meanCi.second;
+            }
+          csv << "\n";
+        }
+    }
+}
+
+int
+SweepRunner::Run (Callback<void, int, char**> run)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t nPoints = GetNPoints ();
+  bool replicating = m_maxReplications > 1;
+  std::cout << "Sweep: " << nPoints << " points";
+  if (replicating)
+    {
+      std::cout << ", " << m_minReplications << "-" << m_maxReplications << " replications each";
+    }
+  std::cout << " on " << m_jobs << " workers";
+  if (m_batch > 1)
+    {
+      std::cout << ", up to " << m_batch << " runs each";
+    }
+  std::cout << "\n";
+
+  auto start = std::chrono::steady_clock::now ();
+  struct Worker {
+    std::vector<Task> tasks;
+    int reportFd;
+  };
+  std::map<pid_t, Worker> workers;
+  std::vector<PointResults> results (nPoints);
+  uint32_t runs = 0, failed = 0;
+
+  // the cores a nested runner in each worker may use
+  uint32_t concurrent = std::max<uint32_t> (1, std::min<uint32_t> (m_jobs, nPoints * m_minReplications));
+  uint32_t workerJobs = std::max<uint32_t> (1, m_jobs / concurrent);
+
+  while (true)
+    {
+      // the runs that can start now, dealt round-robin over the idle
+      // workers so that a short sweep still uses all of them
+      uint32_t idle = m_jobs - workers.size ();
+      std::vector<Task> ready;
+      int32_t next;
+      while (ready.size () < idle * m_batch && (next = GetNextPoint (results)) >= 0)
+        {
+          Task task = {uint32_t (next), results[next].started};
+          ready.push_back (task);
+          results[next].started++;
+          results[next].running++;
+        }
+      std::vector<Worker> batches (std::min<size_t> (idle, ready.size ()));
+      for (uint32_t i = 0; i < ready.size (); i++)
+        {
+          batches[i % batches.size ()].tasks.push_back (ready[i]);
+        }
+
+      for (Worker &worker : batches)
+        {
+          int fds[2];
+          if (pipe (fds) < 0)
+            {
+              NS_FATAL_ERROR ("pipe() failed for sweep point " << worker.tasks[0].point);
+            }
+          std::cout.flush ();
+          std::fflush (0);
+          pid_t pid = fork ();
+          if (pid < 0)
+            {
+              NS_FATAL_ERROR ("fork() failed for sweep point " << worker.tasks[0].point);
+            }
+          else if (pid == 0)
+            {
+              close (fds[0]);
+              s_workerJobs = workerJobs;
+              RunBatch (worker.tasks, fds[1], run);
+            }
+          close (fds[1]);
+          worker.reportFd = fds[0];
+          NS_LOG_INFO ("Started " << worker.tasks.size () << " runs from point " << worker.tasks[0].point
+                       << " in worker " << pid);
+          runs += worker.tasks.size ();
+          workers[pid] = worker;
+        }
+      if (workers.empty ())
+        {
+          break;
+        }
+
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid < 0)
+        {
+          NS_FATAL_ERROR ("waitpid() failed with " << workers.size () << " workers running");
+        }
+      std::map<pid_t, Worker>::iterator it = workers.find (pid);
+      if (it == workers.end ())
+        {
+          continue;
+        }
+      Worker worker = it->second;
+      workers.erase (it);
+      for (const Task &task : worker.tasks)
+        {
+          results[task.point].running--;
+        }
+
+      // a failed run's metrics, if any, are not counted, nor are those of the runs it cut off
+      uint32_t done = ReadReport (worker.reportFd, worker.tasks, results);
+      close (worker.reportFd);
+      for (uint32_t i = done; i < worker.tasks.size (); i++)
+        {
+          std::cerr << "Sweep point failed:";
+          for (std::string arg : GetPointArgs (worker.tasks[i].point))
+            {
+              std::cerr << " " << arg;
+            }
+          if (replicating)
+            {
+              std::cerr << " --RngRun=" << worker.tasks[i].replication + 1;
+            }
+          std::cerr << "\n";
+          failed++;
+        }
+      if (done == worker.tasks.size () && !(WIFEXITED (status) && WEXITSTATUS (status) == 0))
+        {
+          std::cerr << "Sweep worker " << pid << " failed after its runs\n";
+        }
+    }
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - start;
+  std::cout << "Sweep: " << runs - failed << "/" << runs << " runs of " << nPoints << " points done in "
+            << elapsed.count () << "s (" << (runs - failed) * 60 / elapsed.count () << " runs/min)\n";
+  if (replicating)
+    {
+      PrintReplications (results);
+    }
+
+  return failed ? 1 : 0;
+}
+
+} // namespace ns3
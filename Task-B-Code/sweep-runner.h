@@ -0,0 +1,137 @@
+#ifndef SWEEPRUNNER_H
+#define SWEEPRUNNER_H
+
+#include "ns3/callback.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Runs a scenario over a parameter grid.
+ *
+ * The grid is given on the command line as
+ * --sweep="congestionAlgo=TcpNewReno,TcpVegas;n_nodes=1,4;error_rate=0,0.02"
+ * and every point of the cross product is run in its own forked worker
+ * process, at most --jobs of them at a time (default: one per core).
+ * Workers are forked after the modules are loaded, so each point skips
+ * the waf start up and TypeId registration a separate ./waf --run pays.
+ *
+ * With --replications=N, each point is run with --RngRun=1, 2, ... up to
+ * N times.  The workers hand their metrics back through Report.  After
+ * --minReplications runs (default 3) have finished, idle workers start
+ * more runs of the points whose 95% confidence interval of some metric
+ * is still wider than --ciTarget (default 0.05, i.e. +-5%) of its mean,
+ * until it is within or N runs are started.  Runs already started when
+ * a point converges still count, so a point can get a few more than it
+ * needed.
+ * The mean and interval of each point are printed at the end, and
+ * appended to --replicationCsv if given.
+ *
+ * With --batch=N, each worker runs up to N points (or replications)
+ * back to back in one process instead of forking once per run.  The
+ * runs that can start are dealt round-robin over the idle workers, so
+ * batches only fill up when there are runs enough for every job.  Between
+ * runs the simulator is destroyed and the attribute defaults, global
+ * values, object names and random stream numbers are reset, so a run
+ * matches a freshly forked one as long as the scenario also resets the
+ * state of the modules it uses (e.g. Ipv6AddressGenerator::Reset) and
+ * its own globals.  A run that exits stops the rest of its batch, which
+ * counts as failed.
+ *
+ * A runner created inside a worker (e.g. for a warm start's variants)
+ * defaults to that worker's share of the outer --jobs instead of one job
+ * per core, so nested sweeps don't run jobs^2 processes.
+ */
+class SweepRunner {
+public:
+  SweepRunner ();
+
+  /**
+   * Take --sweep, --jobs and the replication options out of argv,
+   * keeping the other arguments as the base arguments of every point.
+   * \return true if a sweep or replications were requested
+   */
+  bool Parse (int argc, char** argv);
+
+  void AddAxis (std::string name, std::vector<std::string> values);
+
+  /** Add the axes of a "name=v1,v2;name2=v1,v2" spec, as given to --sweep. */
+  void AddAxes (std::string spec);
+
+  /** Replace the arguments every point starts from (argv[0] included). */
+  void SetBaseArgs (int argc, char** argv);
+
+  void SetJobs (uint32_t jobs);
+
+  /** Runs per worker process, 1 (the default) to fork for every run. */
+  void SetBatch (uint32_t runs);
+  uint32_t GetBatch () const;
+
+  /**
+   * \param ciTarget half width of the 95% confidence interval, relative
+   * to the mean, at which a point stops getting runs; 0 always runs max
+   */
+  void SetReplications (uint32_t min, uint32_t max, double ciTarget);
+  void SetReplicationCsv (std::string fileName);
+
+  uint32_t GetNPoints () const;
+  std::vector<std::string> GetPointArgs (uint32_t point) const;
+
+  /**
+   * Run every point through the scenario.  Each worker calls run with
+   * the base arguments followed by the point's --name=value arguments.
+   * \return 0 if every point exited cleanly, 1 otherwise
+   */
+  int Run (Callback<void, int, char**> run);
+
+  /** True in a worker whose metrics Report passes to the runner. */
+  static bool IsReplicating ();
+
+  /** Hand a run's metrics (name, value) to the runner; does nothing outside a replication worker. */
+  static void Report (std::vector<std::pair<std::string, double> > metrics);
+
+private:
+  struct PointResults {
+    uint32_t started = 0;
+    uint32_t running = 0;
+    std::vector<std::string> names;
+    std::vector<std::vector<double> > samples;   //!< per metric, per finished run
+  };
+
+  struct Task {
+    uint32_t point;
+    uint32_t replication;
+  };
+
+  void RunPoint (const Task &task, Callback<void, int, char**> run);
+  /** Run the tasks one after the other in this worker, then exit. */
+  void RunBatch (const std::vector<Task> &tasks, int reportFd, Callback<void, int, char**> run);
+  /** The point to start a run of next, or -1 if none should start now. */
+  int32_t GetNextPoint (const std::vector<PointResults> &results) const;
+  /** False until every metric has 2 samples and its CI is within the target. */
+  bool IsConverged (const PointResults &results) const;
+  /** \return the number of tasks that finished, whose metrics are added to results */
+  uint32_t ReadReport (int fd, const std::vector<Task> &tasks, std::vector<PointResults> &results) const;
+  void ParseMetrics (std::string report, PointResults &results) const;
+  void PrintReplications (const std::vector<PointResults> &results) const;
+
+  std::vector<std::string> m_baseArgs;
+  std::vector<std::string> m_names;
+  std::vector<std::vector<std::string> > m_values;
+  uint32_t m_jobs;
+  uint32_t m_batch;
+  uint32_t m_minReplications;
+  uint32_t m_maxReplications;
+  double m_ciTarget;
+  std::string m_replicationCsv;
+
+  static int s_reportFd;
+  static bool s_replicating;
+  static uint32_t s_workerJobs;   //!< in a worker, its share of the outer jobs; 0 outside
+};
+
+}
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef TCPACKTRACE_H
+#define TCPACKTRACE_H
+
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-socket-state.h"
+#include "ns3/nstime.h"
+#include "ns3/fatal-error.h"
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * One event of the ACK/loss process seen by a TCP sender.
+ *
+ * In a trace file each event is a line
+ *   <flow> <time ns> ack <segmentsAcked> <rtt ns>
+ *   <flow> <time ns> loss
+ */
+struct TcpAckEvent {
+  enum Type { ACK, LOSS };
+
+  uint32_t flow {0};
+  Type type {ACK};
+  int64_t time {0};
+  uint32_t segmentsAcked {0};
+  int64_t rtt {0};
+};
+
+class TcpAckTrace {
+public:
+  static void Write (std::ostream &os, const TcpAckEvent &event)
+  {
+    os << event.flow << " " << event.time;
+    if (event.type == TcpAckEvent::ACK)
+      {
+        os << " ack " << event.segmentsAcked << " " << event.rtt << "\n";
+      }
+    else
+      {
+        os << " loss\n";
+      }
+  }
+
+  static std::vector<TcpAckEvent> Read (std::string fileName)
+  {
+    std::ifstream is (fileName.c_str ());
+    if (!is.is_open ())
+      {
+        NS_FATAL_ERROR ("Can't open ACK trace " << fileName);
+      }
+    std::vector<TcpAckEvent> events;
+    std::string line, type;
+    while (std::getline (is, line))
+      {
+        std::istringstream ls (line);
+        TcpAckEvent event;
+        if (!(ls >> event.flow >> event.time >> type))
+          {
+            continue;
+          }
+        if (type == "ack")
+          {
+            ls >> event.segmentsAcked >> event.rtt;
+          }
+        else
+          {
+            event.type = TcpAckEvent::LOSS;
+          }
+        events.push_back (event);
+      }
+    return events;
+  }
+
+  /**
+   * A single flow ACK stream with delayed ACKs (two segments per ACK),
+   * RTT jitter of up to +20% around rtt and independent losses.
+   */
+  static std::vector<TcpAckEvent> Synthesize (uint32_t nAcks, double lossRate, Time rtt,
+                                              uint32_t seed)
+  {
+    std::mt19937 rng (seed);
+    std::uniform_real_distribution<double> uniform (0, 1);
+    std::vector<TcpAckEvent> events;
+    events.reserve (nAcks + nAcks * lossRate * 2);
+    int64_t now = 0;
+    for (uint32_t i = 0; i < nAcks; i++)
+      {
+        now += rtt.GetNanoSeconds () / 16;
+        if (uniform (rng) < lossRate)
+          {
+            TcpAckEvent loss;
+            loss.type = TcpAckEvent::LOSS;
+            loss.time = now;
+            events.push_back (loss);
+          }
+        TcpAckEvent ack;
+        ack.time = now;
+        ack.segmentsAcked = 2;
+        ack.rtt = rtt.GetNanoSeconds () * (1 + 0.2 * uniform (rng));
+        events.push_back (ack);
+      }
+    return events;
+  }
+};
+
+/**
+ * Drives a TcpCongestionOps the way TcpSocketBase does, but from a
+ * recorded ACK/loss sequence instead of a simulated connection.  A loss
+ * is a fast recovery collapsed to one step: enter CA_RECOVERY, take the
+ * new ssThresh, deflate cwnd to it and go back to CA_OPEN.
+ */
+class TcpAckTraceDriver {
+public:
+  TcpAckTraceDriver (Ptr<TcpCongestionOps> cc, uint32_t segmentSize, uint32_t initialCwnd)
+    : m_cc (cc),
+      m_tcb (CreateObject<TcpSocketState> ())
+  {
+    m_tcb->m_segmentSize = segmentSize;
+    m_tcb->m_initialCWnd = initialCwnd;
+    m_tcb->m_cWnd = initialCwnd * segmentSize;
+    m_tcb->m_ssThresh = UINT32_MAX;
+    m_tcb->m_nextTxSequence = m_tcb->m_lastAckedSeq + m_tcb->m_cWnd.Get ();
+    m_tcb->m_bytesInFlight = m_tcb->m_cWnd.Get ();
+    m_cc->Init (m_tcb);
+    m_cc->CongestionStateSet (m_tcb, TcpSocketState::CA_OPEN);
+  }
+
+  void Apply (const TcpAckEvent &event)
+  {
+    if (event.type == TcpAckEvent::ACK)
+      {
+        Time rtt = NanoSeconds (event.rtt);
+        m_tcb->m_lastAckedSeq += event.segmentsAcked * m_tcb->m_segmentSize;
+        m_tcb->m_lastRtt = rtt;
+        m_cc->PktsAcked (m_tcb, event.segmentsAcked, rtt);
+        m_cc->IncreaseWindow (m_tcb, event.segmentsAcked);
+      }
+    else
+      {
+        m_cc->CongestionStateSet (m_tcb, TcpSocketState::CA_RECOVERY);
+        m_tcb->m_congState = TcpSocketState::CA_RECOVERY;
+        m_tcb->m_ssThresh = m_cc->GetSsThresh (m_tcb, m_tcb->m_bytesInFlight);
+        m_tcb->m_cWnd = m_tcb->m_ssThresh.Get ();
+        m_cc->CongestionStateSet (m_tcb, TcpSocketState::CA_OPEN);
+        m_tcb->m_congState = TcpSocketState::CA_OPEN;
+      }
+    m_tcb->m_nextTxSequence = m_tcb->m_lastAckedSeq + m_tcb->m_cWnd.Get ();
+    m_tcb->m_highTxMark = m_tcb->m_nextTxSequence.Get ();
+    m_tcb->m_bytesInFlight = m_tcb->m_cWnd.Get ();
+  }
+
+  Ptr<TcpSocketState> GetState () const { return m_tcb; }
+
+private:
+  Ptr<TcpCongestionOps> m_cc;
+  Ptr<TcpSocketState> m_tcb;
+};
+
+}
+
+#endif
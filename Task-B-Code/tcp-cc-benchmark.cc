@@ -0,0 +1,108 @@
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/tcp-ack-trace.h"
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+using namespace ns3;
+
+/*
+    Per-ACK cost of TcpCongestionOps implementations, without a simulation:
+    each algorithm is driven through the same ACK/loss sequence (recorded
+    with mywpanB --recordAckTrace, or synthesized) and the time spent in
+    PktsAcked/IncreaseWindow/GetSsThresh is reported as ns per ACK.
+*/
+
+uint n_acks=1000000, iterations=5, pkt_sz=100, initial_cwnd=10, seed=1;
+double loss_rate=0.001;
+string algos="TcpLrNewReno,TcpNewReno,TcpVegas", traceFile, maxNsPerAck;
+map<string, double> thresholds;
+
+vector<string> split(string s, char sep) {
+    vector<string> parts;
+    istringstream is(s);
+    string part;
+    while( getline(is, part, sep) ) if( part!="" ) parts.push_back(part);
+    return parts;
+}
+
+void processArguments(int argc, char** argv) {
+    CommandLine cmd (__FILE__);
+    cmd.AddValue ("algos", "Congestion Control Algorithms", algos);
+    cmd.AddValue ("trace", "ACK Trace File (synthetic if empty)", traceFile);
+    cmd.AddValue ("n_acks", "Number of Synthetic ACKs", n_acks);
+    cmd.AddValue ("loss_rate", "Synthetic Loss Rate Per ACK", loss_rate);
+    cmd.AddValue ("seed", "Synthetic Trace Seed", seed);
+    cmd.AddValue ("pkt_sz", "Segment Size", pkt_sz);
+    cmd.AddValue ("iterations", "Timed Passes Per Algorithm", iterations);
+    cmd.AddValue ("maxNsPerAck", "Regression Thresholds, e.g. TcpLrNewReno:50,TcpNewReno:40", maxNsPerAck);
+    cmd.Parse (argc, argv);
+
+    for( string threshold : split(maxNsPerAck, ',') ) {
+        vector<string> kv = split(threshold, ':');
+        if( kv.size()!=2 ) {
+            std::cout << "Bad Threshold " << threshold << "\n";
+            exit(1);
+        }
+        thresholds[kv[0]] = stod(kv[1]);
+    }
+}
+
+// one driver per recorded flow, all fed from the same event sequence
+double runPass(TypeId tid, const vector<TcpAckEvent>& events, uint64_t& acks) {
+    ObjectFactory factory;
+    factory.SetTypeId (tid);
+    map<uint32_t, TcpAckTraceDriver> drivers;
+    for( const TcpAckEvent& event : events ) {
+        if( drivers.find(event.flow)==drivers.end() )
+            drivers.emplace(event.flow, TcpAckTraceDriver (factory.Create<TcpCongestionOps> (), pkt_sz, initial_cwnd));
+    }
+
+    acks = 0;
+    auto start = chrono::steady_clock::now();
+    for( const TcpAckEvent& event : events ) {
+        drivers.find(event.flow)->second.Apply(event);
+        if( event.type==TcpAckEvent::ACK ) acks++;
+    }
+    chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main (int argc, char** argv) {
+    processArguments(argc, argv);
+
+    vector<TcpAckEvent> events;
+    if( traceFile!="" ) events = TcpAckTrace::Read(traceFile);
+    else events = TcpAckTrace::Synthesize(n_acks, loss_rate, MilliSeconds (50), seed);
+
+    std::cout << "\n--------------------------------------------------------------------------\n";
+    std::cout << "Events: " << events.size() << ", Segment Size: " << pkt_sz << ", Passes: " << iterations;
+    std::cout << "\n--------------------------------------------------------------------------\n";
+
+    bool regression = false;
+    for( string algo : split(algos, ',') ) {
+        TypeId tid = TypeId::LookupByName ("ns3::" + algo);
+        uint64_t acks;
+        runPass(tid, events, acks);
+
+        double best = 0;
+        for( uint i=0; i<iterations; i++ ) {
+            double ns = runPass(tid, events, acks) / acks;
+            if( i==0 || ns<best ) best = ns;
+        }
+
+        std::cout << algo << ": " << best << " ns/ACK";
+        if( thresholds.count(algo) && best>thresholds[algo] ) {
+            std::cout << "  REGRESSION (limit " << thresholds[algo] << " ns/ACK)";
+            regression = true;
+        }
+        std::cout << "\n";
+    }
+
+    Simulator::Destroy ();
+
+    return regression ? 1 : 0;
+}
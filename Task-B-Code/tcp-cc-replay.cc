@@ -0,0 +1,113 @@
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/tcp-ack-trace.h"
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+using namespace ns3;
+
+/*
+    Replays the ACK/loss process recorded by mywpanB --recordAckTrace
+    against other congestion control algorithms, so they are compared on
+    exactly the same channel without simulating lr-wpan/6LoWPAN again.
+
+    The replay is open loop: ACK timing and losses are the recorded ones,
+    whatever window the replayed algorithm would have had. The estimated
+    throughput is the time average of cwnd/RTT, which is what the window
+    would allow on that path, not what a simulation would measure.
+*/
+
+uint pkt_sz=100, initial_cwnd=10;
+string algos="TcpNewReno,TcpVegas,TcpLrNewReno", traceFile;
+
+struct FlowReplay {
+    int64_t lastTime=-1, lastRtt=0;
+    double cwndTime=0, rateTime=0;
+    uint reductions=0;
+};
+
+vector<string> split(string s, char sep) {
+    vector<string> parts;
+    istringstream is(s);
+    string part;
+    while( getline(is, part, sep) ) if( part!="" ) parts.push_back(part);
+    return parts;
+}
+
+void processArguments(int argc, char** argv) {
+    CommandLine cmd (__FILE__);
+    cmd.AddValue ("trace", "ACK Trace File", traceFile);
+    cmd.AddValue ("algos", "Congestion Control Algorithms", algos);
+    cmd.AddValue ("pkt_sz", "Segment Size", pkt_sz);
+    cmd.AddValue ("initial_cwnd", "Initial Window In Segments", initial_cwnd);
+    cmd.Parse (argc, argv);
+
+    if( traceFile=="" ) {
+        std::cout << "ACK Trace File Required\n";
+        exit(0);
+    }
+}
+
+void replay(string algo, const vector<TcpAckEvent>& events) {
+    ObjectFactory factory;
+    factory.SetTypeId ("ns3::" + algo);
+    map<uint32_t, TcpAckTraceDriver> drivers;
+    map<uint32_t, FlowReplay> flows;
+
+    int64_t first=events.front().time, last=events.back().time;
+    for( const TcpAckEvent& event : events ) {
+        if( drivers.find(event.flow)==drivers.end() )
+            drivers.emplace(event.flow, TcpAckTraceDriver (factory.Create<TcpCongestionOps> (), pkt_sz, initial_cwnd));
+        TcpAckTraceDriver& driver = drivers.find(event.flow)->second;
+        FlowReplay& flow = flows[event.flow];
+
+        double cwnd = driver.GetState ()->m_cWnd.Get ();
+        if( flow.lastTime>=0 ) {
+            double dt = event.time - flow.lastTime;
+            flow.cwndTime += cwnd * dt;
+            if( flow.lastRtt>0 ) flow.rateTime += cwnd / flow.lastRtt * dt;
+        }
+        flow.lastTime = event.time;
+        if( event.type==TcpAckEvent::ACK ) flow.lastRtt = event.rtt;
+        else flow.reductions++;
+
+        driver.Apply(event);
+    }
+
+    double span = last - first, meanCwnd = 0, throughput = 0;
+    uint reductions = 0;
+    for( auto& it : flows ) {
+        if( span>0 ) {
+            meanCwnd += it.second.cwndTime / span / pkt_sz;
+            // bytes per ns to kbps, as processFlowB
+            throughput += it.second.rateTime / span * 8e9 / 1024;
+        }
+        reductions += it.second.reductions;
+    }
+
+    std::cout << algo << ": Mean Cwnd " << meanCwnd / flows.size() << " segments, "
+              << "Reductions " << reductions << ", "
+              << "Est. Throughput " << throughput << " kbps\n";
+}
+
+int main (int argc, char** argv) {
+    processArguments(argc, argv);
+
+    vector<TcpAckEvent> events = TcpAckTrace::Read(traceFile);
+    if( events.empty() ) {
+        std::cout << "Empty ACK Trace\n";
+        return 0;
+    }
+
+    std::cout << "\n--------------------------------------------------------------------------\n";
+    std::cout << "Trace: " << traceFile << ", Events: " << events.size();
+    std::cout << "\n--------------------------------------------------------------------------\n";
+
+    for( string algo : split(algos, ',') ) replay(algo, events);
+
+    Simulator::Destroy ();
+
+    return 0;
+}
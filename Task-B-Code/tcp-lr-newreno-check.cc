@@ -0,0 +1,151 @@
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/tcp-lr-newreno.h"
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <string>
+using namespace std;
+using namespace ns3;
+
+/*
+    Checks that TcpLrNewReno's FixedPoint window update gives the same
+    cwnd and the same Ideal_CW decisions as the double one. A pair of
+    sockets, one per mode, is driven through random congestion avoidance
+    states, and the cases where the two could part are forced:
+
+        exact   seg*(CW_MAX-cWnd) a multiple of alpha*cWnd, where the
+                double quotient can land just below the integer one
+        square  seg*seg a multiple of alpha*cWnd, above CW_MAX
+        ideal   the window ending exactly at beta*CW_MAX - ssThresh past
+                CW_MAX, the edge of the Ideal_CW compare
+
+    Exits non-zero and prints the first differing state on a mismatch.
+    fixedPointCheck.sh runs it before comparing the Task B grid.
+*/
+
+uint64_t n_cases=2000000, seed=1, checked=0;
+string betas="0.5,0.25,0.75,0.3";
+
+struct Pair {
+    Ptr<TcpLrNewReno> doubleOps, fixedOps;
+    uint64_t doubleIdeal=0, fixedIdeal=0;
+};
+
+void countIdeal(uint64_t* count, uint64_t oldValue, uint64_t newValue) {
+    *count = newValue;
+}
+
+Ptr<TcpLrNewReno> createOps(bool fixedPoint, uint32_t alpha, double beta, uint64_t* idealCount) {
+    Ptr<TcpLrNewReno> ops = CreateObject<TcpLrNewReno> ();
+    ops->SetAttribute ("FixedPoint", BooleanValue (fixedPoint));
+    ops->SetAlpha (alpha);
+    ops->SetBeta (beta);
+    ops->TraceConnectWithoutContext ("IdealCwActivations", MakeBoundCallback (&countIdeal, idealCount));
+    return ops;
+}
+
+// reused from case to case
+Ptr<TcpSocketState> doubleTcb, fixedTcb, lossTcb;
+
+void setState(Ptr<TcpSocketState> tcb, uint32_t seg, uint32_t cWnd, uint32_t ssThresh) {
+    tcb->m_segmentSize = seg;
+    tcb->m_cWnd = cWnd;
+    tcb->m_ssThresh = ssThresh;
+}
+
+// one IncreaseWindow in congestion avoidance with CW_MAX set by a loss at cwMax
+bool check(Pair& pair, uint32_t seg, uint32_t cwMax, uint32_t cWnd, uint32_t ssThresh, const char* kind) {
+    ssThresh = min(ssThresh, cWnd);
+    setState(doubleTcb, seg, cWnd, ssThresh);
+    setState(fixedTcb, seg, cWnd, ssThresh);
+    setState(lossTcb, seg, cwMax, ssThresh);
+    pair.doubleOps->GetSsThresh (lossTcb, cwMax);
+    pair.fixedOps->GetSsThresh (lossTcb, cwMax);
+
+    pair.doubleOps->IncreaseWindow (doubleTcb, 1);
+    pair.fixedOps->IncreaseWindow (fixedTcb, 1);
+    checked++;
+    if( doubleTcb->m_cWnd.Get()==fixedTcb->m_cWnd.Get() && pair.doubleIdeal==pair.fixedIdeal ) return true;
+
+    std::cout << "Mismatch (" << kind << "): seg " << seg << ", CW_MAX " << cwMax << ", cWnd " << cWnd
+              << ", ssThresh " << ssThresh << ", alpha " << pair.doubleOps->GetAlpha ()
+              << ", beta " << pair.doubleOps->GetBeta () << " -> double " << doubleTcb->m_cWnd
+              << " (" << pair.doubleIdeal << " Ideal_CW), fixed " << fixedTcb->m_cWnd
+              << " (" << pair.fixedIdeal << " Ideal_CW)\n";
+    return false;
+}
+
+int main (int argc, char** argv) {
+    CommandLine cmd (__FILE__);
+    cmd.AddValue ("n_cases", "States Checked Per Kind", n_cases);
+    cmd.AddValue ("seed", "Random Seed", seed);
+    cmd.AddValue ("betas", "Beta Values To Check", betas);
+    cmd.Parse (argc, argv);
+
+    vector<double> betaValues;
+    size_t start=0, end;
+    while( (end=betas.find(',', start))!=string::npos ) {
+        betaValues.push_back(stod(betas.substr(start, end-start)));
+        start = end+1;
+    }
+    betaValues.push_back(stod(betas.substr(start)));
+
+    doubleTcb = CreateObject<TcpSocketState> ();
+    fixedTcb = CreateObject<TcpSocketState> ();
+    lossTcb = CreateObject<TcpSocketState> ();
+
+    mt19937_64 rng (seed);
+    auto uniform = [&rng](uint64_t lo, uint64_t hi) { return lo + rng() % (hi-lo+1); };
+
+    // the trace sinks point into the pairs
+    vector<Pair> pairs;
+    pairs.reserve(8*betaValues.size());
+    for( uint32_t alpha : {1u, 2u, 3u, 4u, 5u, 8u, 12u, 16u} ) {
+        for( double beta : betaValues ) {
+            pairs.push_back(Pair ());
+            Pair& pair = pairs.back();
+            pair.doubleOps = createOps(false, alpha, beta, &pair.doubleIdeal);
+            pair.fixedOps = createOps(true, alpha, beta, &pair.fixedIdeal);
+        }
+    }
+
+    for( uint64_t i=0; i<n_cases; i++ ) {
+        Pair& pair = pairs[i % pairs.size()];
+        uint32_t alpha = pair.doubleOps->GetAlpha ();
+        double beta = pair.doubleOps->GetBeta ();
+
+        // random states on both sides of CW_MAX
+        uint32_t seg = uniform(1, 1500);
+        uint32_t cWnd = uniform(seg, 1u << 24), cwMax = uniform(seg, 1u << 24);
+        if( !check(pair, seg, cwMax, cWnd, uniform(0, cWnd), "random") ) return 1;
+
+        // exact: cWnd < CW_MAX and alpha*cWnd divides seg*(CW_MAX-cWnd)
+        uint64_t den = uint64_t(alpha)*cWnd;
+        uint64_t step = den / std::gcd<uint64_t>(seg, den);
+        uint64_t gap = step * uniform(1, 4);
+        if( cWnd + gap < (1ull << 32) ) {
+            if( !check(pair, seg, cWnd+gap, cWnd, uniform(0, cWnd), "exact") ) return 1;
+        }
+
+        // square: seg = x*y*alpha, cWnd = x*x*alpha, so seg*seg/(alpha*cWnd) = y*y
+        uint32_t x = uniform(1, 60), y = uniform(1, 60);
+        if( uint64_t(x)*y*alpha<=65535 ) {
+            uint32_t sqSeg = x*y*alpha, sqCwnd = x*x*alpha;
+            if( !check(pair, sqSeg, uniform(1, sqCwnd), sqCwnd, uniform(0, sqCwnd), "square") ) return 1;
+        }
+
+        // ideal: ssThresh such that the new excess equals beta*CW_MAX - ssThresh
+        // give or take one, as the double compare sees it
+        uint32_t idealCwMax = uniform(seg, 1u << 20);
+        uint32_t idealCwnd = idealCwMax + uniform(0, idealCwMax/2);
+        uint32_t increase = max<uint32_t>(1, (seg*seg) / (alpha*idealCwnd));
+        int64_t edge = int64_t(floor(beta*idealCwMax)) - (int64_t(idealCwnd) + increase - idealCwMax);
+        for( int64_t d=-1; d<=1; d++ ) {
+            if( edge+d>=0 && !check(pair, seg, idealCwMax, idealCwnd, uint32_t(edge+d), "ideal") ) return 1;
+        }
+    }
+
+    std::cout << checked << " States, " << pairs.size() << " Alpha/Beta Pairs: FixedPoint Matches The Double Update\n";
+    return 0;
+}
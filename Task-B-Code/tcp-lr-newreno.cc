@@ -1,11 +1,31 @@
 #include "tcp-lr-newreno.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/trace-source-accessor.h"
+#include <cmath>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TcpLrNewReno");
+
+// Building with -DLEAN_LOGGING compiles the logging of the per-ACK paths
+// out; the counters below are kept either way.
+#ifdef LEAN_LOGGING
+#define LR_LOG_FUNCTION(parameters)
+#define LR_LOG_INFO(msg)
+#define LR_LOG_DEBUG(msg)
+#else
+#define LR_LOG_FUNCTION(parameters) NS_LOG_FUNCTION (parameters)
+#define LR_LOG_INFO(msg) NS_LOG_INFO (msg)
+#define LR_LOG_DEBUG(msg) NS_LOG_DEBUG (msg)
+#endif
 NS_OBJECT_ENSURE_REGISTERED (TcpLrNewReno);
+NS_OBJECT_ENSURE_REGISTERED (TcpLrNewReno_2_1_2);
+NS_OBJECT_ENSURE_REGISTERED (TcpLrNewReno_4_1_2);
+NS_OBJECT_ENSURE_REGISTERED (TcpLrNewReno_8_1_2);
 
 TypeId
 TcpLrNewReno::GetTypeId (void)
@@ -14,6 +34,39 @@ TcpLrNewReno::GetTypeId (void)
     .SetParent<TcpCongestionOps> ()
     .SetGroupName ("Internet")
     .AddConstructor<TcpLrNewReno> ()
+    .AddAttribute ("FixedPoint",
+                   "Use integer arithmetic for the congestion avoidance window update",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpLrNewReno::fixedPoint),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Alpha",
+                   "Divisor of the congestion avoidance window increase",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&TcpLrNewReno::SetAlpha,
+                                         &TcpLrNewReno::GetAlpha),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Beta",
+                   "Fraction of CW_MAX the window may grow past CW_MAX before CW_MAX is kept as the ideal window",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&TcpLrNewReno::SetBeta,
+                                       &TcpLrNewReno::GetBeta),
+                   MakeDoubleChecker<double> (0))
+    .AddTraceSource ("Acks",
+                     "Calls to IncreaseWindow",
+                     MakeTraceSourceAccessor (&TcpLrNewReno::acks),
+                     "ns3::TracedValueCallback::Uint64")
+    .AddTraceSource ("SlowStartEntries",
+                     "IncreaseWindow calls handled in slow start",
+                     MakeTraceSourceAccessor (&TcpLrNewReno::slowStartEntries),
+                     "ns3::TracedValueCallback::Uint64")
+    .AddTraceSource ("CongestionAvoidanceEntries",
+                     "IncreaseWindow calls handled in congestion avoidance",
+                     MakeTraceSourceAccessor (&TcpLrNewReno::congestionAvoidanceEntries),
+                     "ns3::TracedValueCallback::Uint64")
+    .AddTraceSource ("IdealCwActivations",
+                     "Times CW_MAX was kept as the ideal window",
+                     MakeTraceSourceAccessor (&TcpLrNewReno::idealCwActivations),
+                     "ns3::TracedValueCallback::Uint64")
   ;
   return tid;
 }
@@ -21,28 +74,88 @@ TcpLrNewReno::GetTypeId (void)
 TcpLrNewReno::TcpLrNewReno (void) : TcpCongestionOps ()
 {
   NS_LOG_FUNCTION (this);
+  UpdateFixedPointParameters ();
 }
 
 TcpLrNewReno::TcpLrNewReno (const TcpLrNewReno& sock)
-  : TcpCongestionOps (sock)
+  : TcpCongestionOps (sock),
+    alpha (sock.alpha),
+    beta (sock.beta),
+    fixedPoint (sock.fixedPoint)
 {
   NS_LOG_FUNCTION (this);
+  UpdateFixedPointParameters ();
+}
+
+void
+TcpLrNewReno::UpdateFixedPointParameters ()
+{
+  alphaShift = 32;
+  for (uint32_t shift = 0; shift < 32; shift++)
+    {
+      if (alpha == (1u << shift))
+        {
+          alphaShift = shift;
+        }
+    }
+
+  // beta * CW_MAX - ssThresh is exact in a double when beta = betaNum / 2^k
+  // with betaNum < 2^20 and k <= 16, so the integer compare matches it.
+  betaNum = betaDen = 0;
+  for (uint32_t k = 0; k <= 16; k++)
+    {
+      double scaled = std::ldexp (beta, k);
+      if (scaled >= 0 && scaled < (1 << 20) && scaled == std::floor (scaled))
+        {
+          betaNum = static_cast<uint64_t> (scaled);
+          betaDen = 1ull << k;
+          break;
+        }
+    }
 }
 
 TcpLrNewReno::~TcpLrNewReno (void)
 {
 }
 
+void
+TcpLrNewReno::SetAlpha (uint32_t a)
+{
+  NS_LOG_FUNCTION (this << a);
+  alpha = a;
+  UpdateFixedPointParameters ();
+}
+
+uint32_t
+TcpLrNewReno::GetAlpha () const
+{
+  return alpha;
+}
+
+void
+TcpLrNewReno::SetBeta (double b)
+{
+  NS_LOG_FUNCTION (this << b);
+  beta = b;
+  UpdateFixedPointParameters ();
+}
+
+double
+TcpLrNewReno::GetBeta () const
+{
+  return beta;
+}
+
 uint32_t
 TcpLrNewReno::SlowStart (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
 {
-  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+  LR_LOG_FUNCTION (this << tcb << segmentsAcked);
 
   if (segmentsAcked >= 1)
     {
       uint32_t sndCwnd = tcb->m_cWnd;
       tcb->m_cWnd = std::min ((sndCwnd + tcb->m_segmentSize), (uint32_t)tcb->m_ssThresh);
-      NS_LOG_INFO ("In SlowStart, updated to cwnd " << tcb->m_cWnd << " ssthresh " << tcb->m_ssThresh);
+      LR_LOG_INFO ("In SlowStart, updated to cwnd " << tcb->m_cWnd << " ssthresh " << tcb->m_ssThresh);
       return segmentsAcked - ((tcb->m_cWnd - sndCwnd) / tcb->m_segmentSize);
     }
 
@@ -50,8 +163,13 @@ TcpLrNewReno::SlowStart (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
 }
 
 void TcpLrNewReno::CongestionAvoidance (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked) {
-  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
-  if (segmentsAcked > 0){
+  LR_LOG_FUNCTION (this << tcb << segmentsAcked);
+  if (segmentsAcked > 0 && fixedPoint) {
+    uint32_t cWnd = tcb->m_cWnd;
+    IntegerCongestionAvoidance (tcb, alphaShift < 32 ? cWnd << alphaShift : alpha * cWnd,
+                                betaNum, betaDen);
+  }
+  else if (segmentsAcked > 0){
     if( tcb->m_cWnd < CW_MAX ) {
       double num = static_cast<double> ( CW_MAX-tcb->m_cWnd.Get() );
       double den = static_cast<double> ( alpha*tcb->m_cWnd.Get() );
@@ -68,27 +186,57 @@ void TcpLrNewReno::CongestionAvoidance (Ptr<TcpSocketState> tcb, uint32_t segmen
       if( (tcb->m_cWnd - CW_MAX) > (beta*CW_MAX-tcb->m_ssThresh) ) {
         Ideal_CW = CW_MAX;
         Ideal_CW_SET = 1;
+        idealCwActivations++;
       }
     }
   }
-  NS_LOG_DEBUG ("At end of CongestionAvoidance(), m_cWnd: " << tcb->m_cWnd);
+  LR_LOG_DEBUG ("At end of CongestionAvoidance(), m_cWnd: " << tcb->m_cWnd);
 }
 
 void
 TcpLrNewReno::IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
 {
-  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+  LR_LOG_FUNCTION (this << tcb << segmentsAcked);
 
+  acks++;
   if (tcb->m_cWnd < tcb->m_ssThresh)
     {
-      NS_LOG_DEBUG ("In slow start, m_cWnd " << tcb->m_cWnd << " m_ssThresh " << tcb->m_ssThresh);
+      slowStartEntries++;
+      LR_LOG_DEBUG ("In slow start, m_cWnd " << tcb->m_cWnd << " m_ssThresh " << tcb->m_ssThresh);
       segmentsAcked = SlowStart (tcb, segmentsAcked);
     }
   else
     {
-      NS_LOG_DEBUG ("In cong. avoidance, m_cWnd " << tcb->m_cWnd << " m_ssThresh " << tcb->m_ssThresh);
+      congestionAvoidanceEntries++;
+      LR_LOG_DEBUG ("In cong. avoidance, m_cWnd " << tcb->m_cWnd << " m_ssThresh " << tcb->m_ssThresh);
       CongestionAvoidance (tcb, segmentsAcked);
     }
+
+  if (CwndTraceRecorder::Get ())
+    {
+      TraceCwnd (tcb, CwndTraceRecord::ACK, tcb->m_ssThresh);
+    }
+}
+
+void
+TcpLrNewReno::TraceCwnd (Ptr<const TcpSocketState> tcb, uint8_t event, uint32_t ssThresh)
+{
+  CwndTraceRecorder *recorder = CwndTraceRecorder::Get ();
+  if (traceGeneration != recorder->GetGeneration ())
+    {
+      traceRing = recorder->CreateRing ();
+      traceGeneration = recorder->GetGeneration ();
+    }
+
+  CwndTraceRecord record = {};
+  record.time = Simulator::Now ().GetNanoSeconds ();
+  record.flow = traceRing->GetFlow ();
+  record.cWnd = tcb->m_cWnd;
+  record.ssThresh = ssThresh;
+  record.cwMax = CW_MAX;
+  record.idealCw = Ideal_CW;
+  record.event = event;
+  traceRing->Push (record);
 }
 
 std::string
@@ -101,7 +249,7 @@ uint32_t
 TcpLrNewReno::GetSsThresh (Ptr<const TcpSocketState> state,
                            uint32_t bytesInFlight)
 {
-  NS_LOG_FUNCTION (this << state << bytesInFlight);
+  LR_LOG_FUNCTION (this << state << bytesInFlight);
 
   CW_MAX = state->m_cWnd;
   uint32_t ssThresh = std::max<uint32_t> (2 * state->m_segmentSize, state->m_cWnd / 2);
@@ -111,6 +259,11 @@ TcpLrNewReno::GetSsThresh (Ptr<const TcpSocketState> state,
     Ideal_CW_SET = 0;
   }
 
+  if (CwndTraceRecorder::Get ())
+    {
+      TraceCwnd (state, CwndTraceRecord::LOSS, ssThresh);
+    }
+
   return ssThresh;
 }
 
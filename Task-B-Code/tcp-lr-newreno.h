@@ -3,6 +3,10 @@
 
 #include "ns3/tcp-congestion-ops.h"
 #include "ns3/tcp-socket-state.h"
+#include "ns3/traced-value.h"
+#include "cwnd-trace-recorder.h"
+#include <algorithm>
+#include <string>
 
 namespace ns3 {
 
@@ -18,18 +22,167 @@ public:
   virtual uint32_t GetSsThresh (Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight);
   virtual Ptr<TcpCongestionOps> Fork ();
 
+  void SetAlpha (uint32_t a);
+  uint32_t GetAlpha () const;
+  void SetBeta (double b);
+  double GetBeta () const;
+
 protected:
   virtual uint32_t SlowStart (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
   virtual void CongestionAvoidance (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
 
+  /**
+   * Integer version of the CongestionAvoidance window update, giving the
+   * same cwnd as the floating point one for every input.
+   * \param den alpha*cWnd, wrapped to 32 bits like the double version
+   * \param ratioNum beta is ratioNum/ratioDen
+   * \param ratioDen 0 to compare against the beta attribute in a double
+   *
+   * Inline so that TcpLrNewRenoT can fold its constant alpha and beta in.
+   */
+  inline void IntegerCongestionAvoidance (Ptr<TcpSocketState> tcb, uint32_t den,
+                                          uint64_t ratioNum, uint64_t ratioDen);
+
 private:
+  void UpdateFixedPointParameters ();
+  void TraceCwnd (Ptr<const TcpSocketState> tcb, uint8_t event, uint32_t ssThresh);
+
   uint32_t CW_MAX {0};
   uint32_t Ideal_CW {0};
   uint32_t Ideal_CW_SET {0};
   uint32_t  alpha {4}; 
   double  beta {0.5}; 
+
+  bool fixedPoint {false};
+  uint32_t alphaShift {32};   //!< log2 (alpha), or 32 if alpha is not a power of two
+  uint64_t betaNum {0};       //!< beta == betaNum / betaDen
+  uint64_t betaDen {0};       //!< 0 if beta has no small power of two denominator
+
+  TracedValue<uint64_t> acks {0};
+  TracedValue<uint64_t> slowStartEntries {0};
+  TracedValue<uint64_t> congestionAvoidanceEntries {0};
+  TracedValue<uint64_t> idealCwActivations {0};
+
+  CwndTraceRing *traceRing {nullptr};   //!< this flow's ring while CwndTraceRecorder is enabled
+  uint64_t traceGeneration {0};
 };
 
+void
+TcpLrNewReno::IntegerCongestionAvoidance (Ptr<TcpSocketState> tcb, uint32_t den,
+                                          uint64_t ratioNum, uint64_t ratioDen)
+{
+  uint32_t cWnd = tcb->m_cWnd;
+  uint32_t segmentSize = tcb->m_segmentSize;
+
+  if (cWnd < CW_MAX)
+    {
+      // floor (segmentSize * num / den) matches the truncated double
+      // f*(num/den) except when the quotient is exact: the two roundings
+      // of the double can then land just below it, so that (rare) case
+      // takes the floating point expression.
+      uint64_t num = static_cast<uint64_t> (segmentSize) * (CW_MAX - cWnd);
+      uint64_t adder = den ? num / den : 0;
+      if (den == 0 || num % den == 0)
+        {
+          double f = static_cast<double> (segmentSize);
+          adder = static_cast<uint64_t> (std::max (1.0, f * (static_cast<double> (CW_MAX - cWnd)
+                                                             / static_cast<double> (den))));
+        }
+      tcb->m_cWnd += static_cast<uint32_t> (std::max<uint64_t> (1, adder));
+    }
+  else
+    {
+      // A single correctly rounded division truncates to the exact
+      // integer quotient.
+      uint32_t square = segmentSize * segmentSize;
+      if (den)
+        {
+          tcb->m_cWnd += std::max<uint32_t> (1, square / den);
+        }
+      else
+        {
+          tcb->m_cWnd += static_cast<uint32_t> (std::max (1.0, static_cast<double> (square) / den));
+        }
+
+      uint32_t excess = tcb->m_cWnd - CW_MAX;
+      uint32_t ssThresh = tcb->m_ssThresh;
+      bool idealCw;
+      if (ratioDen)
+        {
+          idealCw = (static_cast<uint64_t> (excess) + ssThresh) * ratioDen > ratioNum * CW_MAX;
+        }
+      else
+        {
+          idealCw = excess > (beta*CW_MAX - ssThresh);
+        }
+      if (idealCw)
+        {
+          Ideal_CW = CW_MAX;
+          Ideal_CW_SET = 1;
+          idealCwActivations++;
+        }
+    }
+}
+
+/**
+ * TcpLrNewReno with alpha and beta = BetaNum/BetaDen fixed at compile
+ * time, so the per-ACK update runs on constants (a shift when Alpha is a
+ * power of two).  The window update is always the integer one, and the
+ * Alpha, Beta and FixedPoint attributes are ignored.
+ *
+ * The instantiations in tcp-lr-newreno.cc are registered as
+ * ns3::TcpLrNewReno_<Alpha>_<BetaNum>_<BetaDen>.
+ */
+template <uint32_t Alpha, uint32_t BetaNum, uint32_t BetaDen>
+class TcpLrNewRenoT : public TcpLrNewReno {
+public:
+  static_assert (Alpha > 0 && BetaDen > 0, "TcpLrNewRenoT needs Alpha > 0 and BetaDen > 0");
+
+  static TypeId GetTypeId (void)
+  {
+    static std::string name = "ns3::" + GetTemplateName ();
+    static TypeId tid = TypeId (name.c_str ())
+      .SetParent<TcpLrNewReno> ()
+      .SetGroupName ("Internet")
+      .AddConstructor<TcpLrNewRenoT> ()
+    ;
+    return tid;
+  }
+
+  TcpLrNewRenoT () : TcpLrNewReno () {}
+  TcpLrNewRenoT (const TcpLrNewRenoT& sock) : TcpLrNewReno (sock) {}
+
+  std::string GetName () const
+  {
+    return GetTemplateName ();
+  }
+
+  virtual Ptr<TcpCongestionOps> Fork ()
+  {
+    return CopyObject<TcpLrNewRenoT> (this);
+  }
+
+protected:
+  virtual void CongestionAvoidance (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+  {
+    if (segmentsAcked > 0)
+      {
+        IntegerCongestionAvoidance (tcb, Alpha * tcb->m_cWnd.Get (), BetaNum, BetaDen);
+      }
+  }
+
+private:
+  static std::string GetTemplateName ()
+  {
+    return "TcpLrNewReno_" + std::to_string (Alpha) + "_" + std::to_string (BetaNum)
+           + "_" + std::to_string (BetaDen);
+  }
+};
+
+typedef TcpLrNewRenoT<2, 1, 2> TcpLrNewReno_2_1_2;
+typedef TcpLrNewRenoT<4, 1, 2> TcpLrNewReno_4_1_2;
+typedef TcpLrNewRenoT<8, 1, 2> TcpLrNewReno_8_1_2;
+
 } 
 
 #endif 
@@ -1,28 +1,15 @@
 #!/bin/bash
 
-rm *.flowmonitor
+rm *.flowmonitor *.flowstats
 
-declare -a nodes=(1, 4)
-declare -a error_rate=(0, 0.02, 0.04, 0.06, 0.08, 0.10)
+algos="TcpNewReno,TcpVegas,TcpLrNewReno"
+nodes="1,4"
+error_rate="0,0.02,0.04,0.06,0.08,0.10"
 
-for n in ${nodes[@]}; do
-    for er in ${error_rate[@]}; do
-        ./waf --run "scratch/mywpanB --congestionAlgo=TcpNewReno --n_nodes=$n --error_rate=$er --duration=100"
-    done
-done
+# one worker per node count simulates setup and warm-up once, then forks
+# every (algo, error_rate) variant from that state
+./waf --run "scratch/mywpanB --sweep=n_nodes=$nodes --warmStart=congestionAlgo=$algos;error_rate=$error_rate --duration=100"
 
-for n in ${nodes[@]}; do
-    for er in ${error_rate[@]}; do
-        ./waf --run "scratch/mywpanB --congestionAlgo=TcpVegas --n_nodes=$n --error_rate=$er --duration=100"
-    done
-done
-
-for n in ${nodes[@]}; do
-    for er in ${error_rate[@]}; do
-        ./waf --run "scratch/mywpanB --congestionAlgo=TcpLrNewReno --n_nodes=$n --error_rate=$er --duration=100"
-    done
-done 
-
-python3 processFlowB.py
+if [ -x ./processFlows ]; then ./processFlows --layout=B; else python3 processFlowB.py; fi
 
 libreoffice --headless --convert-to xlsx:"Calc MS Excel 2007 XML" results.csv
\ No newline at end of file